@@ -5,13 +5,15 @@
 #include <memory>
 
 /**
- * Prosta implementacja IMnozenie nazwana AI.
- * Implementuje klasyczne mnożenie (triple loop) z liczeniem operacji
+ * Implementacja IMnozenie nazwana AI - schemat 4x5 * 5x5 z 76 mnożeniami
+ * (AIutils/multa, multb, multc), liczony harmonogramem dodawań ze wspólnymi
+ * podwyrażeniami (Schedules.h, AIutils/cse.py), z liczeniem operacji
  * i przybliżonym accountingiem pamięci via memCounterEnter/Exit.
+ * Wiele niezależnych iloczynów naraz - aiBatched (BatchedGemm.h).
  */
 class AI : public IMnozenie {
 public:
-    Matrix multiply(const Matrix& A, const Matrix& B) override;
+    void multiplyInto(ConstMatrixView A, ConstMatrixView B, MatrixView C) override;
     ~AI() override = default;
 };
 
@@ -0,0 +1,129 @@
+# Generuje Schedules.h - harmonogramy dodawań schematów mnożenia ze wspólnymi
+# podwyrażeniami (CSE) dla AI.cpp i BatchedGemm.cpp (aiBatched).
+#
+# Użycie: python3 cse.py NAZWA M K N KATALOG [NAZWA M K N KATALOG ...] > ../Schedules.h
+#
+# Schedules.h zawiera tylko schemat AI: python3 cse.py AI455 4 5 5 . > ../Schedules.h
+# (Strassen nie ma wspólnych podwyrażeń, a Laderman nie jest nigdzie jądrem stałym).
+#
+# Wejście jak w toscheme.py (multa/multb/multc). Kombinacje liniowe wierszy U
+# (po elementach A), V (po elementach B) i W (po iloczynach) upraszczane są
+# zachłannie: para (x, +-y) występująca w największej liczbie wierszy staje się
+# zmienną pomocniczą, dopóki jakaś para powtarza się co najmniej dwa razy.
+# Wynik to funkcja bez pętli, szablonowa po typie T (double albo wektor pasów
+# SIMD - ten sam harmonogram liczy wtedy kilka problemów naraz), z liczbą
+# dodawań, odejmowań i mnożeń wyliczoną z faktycznie emitowanego kodu.
+import sys
+from collections import Counter
+
+from toscheme import check, load
+
+
+def eliminate(rows, names, prefix):
+    """rows: lista słowników zmienna -> współczynnik. Zwraca listę zmiennych
+    pomocniczych (nazwa, u, znak, v) w kolejności obliczania, rows w miejscu."""
+    temps = []
+    while True:
+        pairs = Counter()
+        for row in rows:
+            unit = sorted(x for x, c in row.items() if c in (1, -1))
+            for i, u in enumerate(unit):
+                for v in unit[i + 1:]:
+                    pairs[(u, v, row[u] * row[v])] += 1
+        if not pairs:
+            break
+        (u, v, s), count = min(pairs.items(), key=lambda item: (-item[1], item[0]))
+        if count < 2:
+            break
+        t = len(names)
+        names.append(f"{prefix}{len(temps)}")
+        temps.append((t, u, s, v))
+        for row in rows:
+            if row.get(u) in (1, -1) and row.get(v) == s * row[u]:
+                row[t] = row.pop(u)
+                del row[v]
+    return temps
+
+
+def expression(row, names, ops):
+    """Suma wiersza od pierwszego dodatniego składnika; aktualizuje ops."""
+    terms = sorted(row.items())
+    if not terms:
+        return "T(0.0)"
+    terms.sort(key=lambda xc: xc[1] < 0)
+    out = ""
+    for i, (x, c) in enumerate(terms):
+        value = names[x] if abs(c) == 1 else f"{abs(c)}.0 * {names[x]}"
+        if abs(c) != 1:
+            ops["muls"] += 1
+        if i == 0:
+            if c == -1:
+                ops["subs"] += 1
+            out = ("-" if c < 0 else "") + value
+        else:
+            ops["adds" if c > 0 else "subs"] += 1
+            out += (" + " if c > 0 else " - ") + value
+    return out
+
+
+def schedule(U, V, W):
+    ops = {"adds": 0, "subs": 0, "muls": len(U)}
+    body = []
+
+    def side(rows, inputs, prefix):
+        names = list(inputs)
+        temps = eliminate(rows, names, prefix)
+        for t, u, s, v in temps:
+            ops["adds" if s > 0 else "subs"] += 1
+            body.append(f"const T {names[t]} = {names[u]} {'+' if s > 0 else '-'} {names[v]};")
+        return names
+
+    urows = [{e: c for e, c in enumerate(row) if c} for row in U]
+    vrows = [{e: c for e, c in enumerate(row) if c} for row in V]
+    wrows = [{r: c for r, c in enumerate(row) if c} for row in W]
+
+    unames = side(urows, [f"a[{e}]" for e in range(len(U[0]))], "sa")
+    vnames = side(vrows, [f"b[{e}]" for e in range(len(V[0]))], "sb")
+    for r in range(len(U)):
+        left = expression(urows[r], unames, ops)
+        right = expression(vrows[r], vnames, ops)
+        left = left if len(urows[r]) == 1 and "-" not in left and "*" not in left else f"({left})"
+        right = right if len(vrows[r]) == 1 and "-" not in right and "*" not in right else f"({right})"
+        body.append(f"const T h{r} = {left} * {right};")
+    wnames = side(wrows, [f"h{r}" for r in range(len(U))], "sc")
+    for o, row in enumerate(wrows):
+        body.append(f"c[{o}] = {expression(row, wnames, ops)};")
+    return body, ops
+
+
+def main(args):
+    if not args or len(args) % 5 != 0:
+        sys.exit("usage: cse.py NAME M K N DIR [NAME M K N DIR ...]")
+
+    print("#pragma once")
+    print()
+    print("// Wygenerowane przez AIutils/cse.py - nie edytować ręcznie.")
+    print("// run(a, b, c): a - A wierszami (M * K), b - B wierszami (K * N),")
+    print("// c - C wierszami (M * N); c nie może nachodzić na a ani b.")
+
+    for g in range(0, len(args), 5):
+        name, directory = args[g], args[g + 4]
+        m, k, n = (int(x) for x in args[g + 1:g + 4])
+        U, V, W = load(name, m, k, n, directory)
+        check(name, m, k, n, U, V, W)
+        body, ops = schedule(U, V, W)
+        print()
+        print(f"struct {name}Schedule {{")
+        print(f"    static constexpr int M = {m}, K = {k}, N = {n}, R = {len(U)};")
+        print(f"    static constexpr int adds = {ops['adds']}, subs = {ops['subs']}, muls = {ops['muls']};")
+        print()
+        print("    template <class T>")
+        print("    static inline __attribute__((always_inline)) void run(const T *a, const T *b, T *c) {")
+        for line in body:
+            print(f"        {line}")
+        print("    }")
+        print("};")
+
+
+if __name__ == "__main__":
+    main(sys.argv[1:])
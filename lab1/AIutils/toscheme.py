@@ -0,0 +1,106 @@
+# Generuje Schemes.h - tablice współczynników schematów mnożenia dla FixedKernels.h.
+#
+# Użycie: python3 toscheme.py NAZWA M K N KATALOG [NAZWA M K N KATALOG ...] > ../Schemes.h
+#
+# KATALOG zawiera multa.txt, multb.txt i multc.txt w formacie tocpp.py:
+# wiersz r plików multa/multb to lewy/prawy czynnik iloczynu h(r+1), token "-31"
+# to -A[2][0] (indeksy od 1); wiersz i pliku multc to C[i % M][i / M] jako suma
+# iloczynów ("-5" to -h5). Przed zapisem schemat jest sprawdzany na losowych
+# macierzach całkowitoliczbowych (wynik musi być dokładny).
+import random
+import sys
+
+
+def parse_factor(path):
+    rows = []
+    for line in open(path).read().split("\n"):
+        if not line.strip():
+            continue
+        rows.append([(-1 if t[0] == "-" else 1, int(t.lstrip("+-")[0]) - 1, int(t.lstrip("+-")[1]) - 1)
+                     for t in line.split()])
+    return rows
+
+
+def parse_output(path):
+    rows = []
+    for line in open(path).read().split("\n"):
+        if not line.strip():
+            continue
+        rows.append([(-1 if t[0] == "-" else 1, int(t.lstrip("+-")) - 1) for t in line.split()])
+    return rows
+
+
+def load(name, m, k, n, directory):
+    a = parse_factor(f"{directory}/multa.txt")
+    b = parse_factor(f"{directory}/multb.txt")
+    c = parse_output(f"{directory}/multc.txt")
+    if len(a) != len(b) or len(c) != m * n:
+        sys.exit(f"{name}: {len(a)} / {len(b)} factors, {len(c)} outputs (expected {m * n})")
+    r = len(a)
+
+    U = [[0] * (m * k) for _ in range(r)]
+    V = [[0] * (k * n) for _ in range(r)]
+    W = [[0] * r for _ in range(m * n)]
+    for p in range(r):
+        for s, i, j in a[p]:
+            U[p][i * k + j] += s
+        for s, i, j in b[p]:
+            V[p][i * n + j] += s
+    for line, terms in enumerate(c):
+        for s, p in terms:
+            W[(line % m) * n + line // m][p] += s
+    return U, V, W
+
+
+def check(name, m, k, n, U, V, W):
+    for _ in range(3):
+        A = [random.randint(-9, 9) for _ in range(m * k)]
+        B = [random.randint(-9, 9) for _ in range(k * n)]
+        h = [sum(u * x for u, x in zip(Ur, A)) * sum(v * x for v, x in zip(Vr, B)) for Ur, Vr in zip(U, V)]
+        for i in range(m):
+            for j in range(n):
+                got = sum(w * x for w, x in zip(W[i * n + j], h))
+                if got != sum(A[i * k + p] * B[p * n + j] for p in range(k)):
+                    sys.exit(f"{name}: wrong C[{i}][{j}]")
+
+
+def table(rows):
+    return "\n".join("        {" + ", ".join(str(x) for x in row) + "}," for row in rows)
+
+
+def main(args):
+    if not args or len(args) % 5 != 0:
+        sys.exit("usage: toscheme.py NAME M K N DIR [NAME M K N DIR ...]")
+
+    print("#pragma once")
+    print()
+    print("// Wygenerowane przez AIutils/toscheme.py - nie edytować ręcznie.")
+    print("// U[r][i * K + k] - współczynnik A[i][k] w lewym czynniku iloczynu r,")
+    print("// V[r][k * N + j] - współczynnik B[k][j] w prawym czynniku,")
+    print("// W[i * N + j][r] - współczynnik iloczynu r w C[i][j].")
+
+    for g in range(0, len(args), 5):
+        name, directory = args[g], args[g + 4]
+        m, k, n = (int(x) for x in args[g + 1:g + 4])
+        U, V, W = load(name, m, k, n, directory)
+        check(name, m, k, n, U, V, W)
+        print()
+        print(f"struct {name} {{")
+        print(f"    static constexpr int M = {m}, K = {k}, N = {n}, R = {len(U)};")
+        print("    static constexpr signed char U[R][M * K] = {")
+        print(table(U))
+        print("    };")
+        print("    static constexpr signed char V[R][K * N] = {")
+        print(table(V))
+        print("    };")
+        print("    static constexpr signed char W[M * N][R] = {")
+        print(table(W))
+        print("    };")
+        print("    static constexpr int u(int r, int e) { return U[r][e]; }")
+        print("    static constexpr int v(int r, int e) { return V[r][e]; }")
+        print("    static constexpr int w(int o, int r) { return W[o][r]; }")
+        print("};")
+
+
+if __name__ == "__main__":
+    main(sys.argv[1:])
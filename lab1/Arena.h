@@ -0,0 +1,80 @@
+#pragma once
+
+#include "Matrix.h"
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+/**
+ * Stosowy alokator (arena) na bufory tymczasowe algorytmów rekurencyjnych.
+ *
+ * Pamięć przydzielana jest przesunięciem wskaźnika (bump pointer) w dużym
+ * bloku, a zwalniana hurtowo - Arena::Scope zapamiętuje wierzchołek przy
+ * wejściu do poziomu rekurencji i przywraca go przy wyjściu. Wywołujący
+ * rezerwuje z góry tyle, ile wynika z rekurencji algorytmu (reserve), więc
+ * w typowym przebiegu cała rekurencja korzysta z jednej alokacji.
+ *
+ * Gdy rezerwacja okaże się za mała (albo jej nie było, np. w wątkach puli),
+ * arena dokłada kolejny blok - wynik jest wtedy nadal poprawny, tylko z dodatkową
+ * alokacją. Bloki zostają do ponownego użycia przez kolejne wywołania.
+ *
+ * Zajętość areny raportowana jest do liczników pamięci (MemStats::arena_*),
+ * czyli rzeczywisty szczyt buforów, a nie oszacowanie z memCounterEnterCall.
+ */
+class Arena {
+public:
+    class Scope {
+    public:
+        explicit Scope(Arena &arena);
+        ~Scope();
+
+        Scope(const Scope &) = delete;
+        Scope &operator=(const Scope &) = delete;
+
+    private:
+        Arena &arena_;
+        std::size_t chunk_;
+        std::size_t offset_;
+        std::size_t used_;
+    };
+
+    Arena() = default;
+    Arena(const Arena &) = delete;
+    Arena &operator=(const Arena &) = delete;
+
+    // Zapewnia count wolnych, ciągłych elementów double na wierzchołku
+    void reserve(std::size_t count);
+
+    // Niezainicjalizowany bufor; początek wyrównany do 64 bajtów
+    double *allocate(std::size_t count);
+    MatrixView allocate(int rows, int cols);
+
+    // Ile elementów zajmuje w arenie bufor count elementów (z wyrównaniem) -
+    // do wyliczania rezerwacji z rekurencji algorytmu
+    static std::size_t footprint(std::size_t count) { return (count + 7) / 8 * 8; }
+    static std::size_t footprint(int rows, int cols) {
+        return footprint(static_cast<std::size_t>(rows) * static_cast<std::size_t>(cols));
+    }
+
+    std::size_t usedBytes() const { return used_ * sizeof(double); }
+    std::size_t peakBytes() const { return peak_ * sizeof(double); }
+    std::size_t capacityBytes() const;
+
+private:
+    struct Chunk {
+        std::unique_ptr<double[]> storage;
+        double *data = nullptr; // storage wyrównane do 64 bajtów
+        std::size_t size = 0;
+        std::size_t used = 0;
+    };
+
+    void release(std::size_t chunk, std::size_t offset, std::size_t used);
+
+    std::vector<Chunk> chunks_;
+    std::size_t current_ = 0; // blok, z którego aktualnie przydzielamy
+    std::size_t used_ = 0;    // elementy zajęte we wszystkich blokach
+    std::size_t peak_ = 0;
+};
+
+// Arena bieżącego wątku
+Arena &threadArena();
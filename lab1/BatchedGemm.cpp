@@ -0,0 +1,248 @@
+#include "BatchedGemm.h"
+#include "Gemm.h"
+#include "Schedules.h"
+#include "Simd.h"
+#include "SupportFunctions.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+
+#define SIMD_AVX2 __attribute__((target("avx2,fma")))
+#define SIMD_AVX512 __attribute__((target("avx512f")))
+
+namespace {
+
+constexpr int kLanes = 8;
+
+// Osiem problemów naraz: przy AVX-512 jeden rejestr, przy AVX2 dwa,
+// w wersji skalarnej kompilator rozbija na SSE2
+typedef double Lanes __attribute__((vector_size(kLanes * sizeof(double))));
+
+// out[i * cols + j][l] = X[l](i, j) dla pełnej grupy kLanes problemów.
+// Wektory składane są w rejestrach - zapis skalarny i odczyt całego
+// wektora z tej samej pamięci blokowałby store forwarding.
+inline __attribute__((always_inline)) void packLanes(const ConstMatrixView *X, int rows, int cols, Lanes *out) {
+    for (int i = 0; i < rows; ++i) {
+        const double *r0 = X[0][i], *r1 = X[1][i], *r2 = X[2][i], *r3 = X[3][i];
+        const double *r4 = X[4][i], *r5 = X[5][i], *r6 = X[6][i], *r7 = X[7][i];
+        for (int j = 0; j < cols; ++j)
+            out[i * cols + j] = Lanes{r0[j], r1[j], r2[j], r3[j], r4[j], r5[j], r6[j], r7[j]};
+    }
+}
+
+inline __attribute__((always_inline)) void unpackLanes(const Lanes *in, int count, int rows, int cols,
+                                                       const MatrixView *X) {
+    for (int l = 0; l < count; ++l)
+        for (int i = 0; i < rows; ++i) {
+            double *Xi = X[l][i];
+            for (int j = 0; j < cols; ++j) Xi[j] = in[i * cols + j][l];
+        }
+}
+
+// Iloczyn skalarny po K w pełni rozwinięty - K znane w czasie kompilacji
+template <int M, int K, int N>
+inline __attribute__((always_inline)) void groupFixed(const Lanes *a, const Lanes *b, Lanes *c) {
+    for (int i = 0; i < M; ++i)
+        for (int j = 0; j < N; ++j) {
+            Lanes acc = a[i * K] * b[j];
+#pragma GCC unroll 16
+            for (int p = 1; p < K; ++p) acc += a[i * K + p] * b[p * N + j];
+            c[i * N + j] = acc;
+        }
+}
+
+inline __attribute__((always_inline)) void groupDynamic(int m, int k, int n, const Lanes *a, const Lanes *b,
+                                                        Lanes *c) {
+    for (int i = 0; i < m; ++i)
+        for (int j = 0; j < n; ++j) {
+            Lanes acc = a[i * k] * b[j];
+            for (int p = 1; p < k; ++p) acc += a[i * k + p] * b[p * n + j];
+            c[i * n + j] = acc;
+        }
+}
+
+// Jedna grupa do kLanes problemów: pakowanie, iloczyn, rozpakowanie.
+// S > 0 - jądro kwadratowe S x S x S, S == 0 - wymiary z argumentów.
+template <int S>
+inline __attribute__((always_inline)) void runGroup(int m, int k, int n, int count, const ConstMatrixView *A,
+                                                    const ConstMatrixView *B, const MatrixView *C) {
+    if constexpr (S > 0) m = k = n = S;
+    // niepełna (ostatnia) grupa: brakujące pasy liczą kopię ostatniego problemu,
+    // a ich wyniki nie są rozpakowywane
+    ConstMatrixView padA[kLanes], padB[kLanes];
+    if (count < kLanes) {
+        for (int l = 0; l < kLanes; ++l) {
+            padA[l] = A[l < count ? l : count - 1];
+            padB[l] = B[l < count ? l : count - 1];
+        }
+        A = padA;
+        B = padB;
+    }
+    Lanes a[kSmallGemmMax * kSmallGemmMax], b[kSmallGemmMax * kSmallGemmMax], c[kSmallGemmMax * kSmallGemmMax];
+    packLanes(A, m, k, a);
+    packLanes(B, k, n, b);
+    if constexpr (S > 0) groupFixed<S, S, S>(a, b, c);
+    else groupDynamic(m, k, n, a, b, c);
+    unpackLanes(c, count, m, n, C);
+}
+
+// Grupa do kLanes problemów kształtu Schedule::M x K * K x N liczona
+// harmonogramem z Schedules.h na wektorach pasów
+template <class Schedule>
+inline __attribute__((always_inline)) void runScheduleGroup(int count, const ConstMatrixView *A,
+                                                            const ConstMatrixView *B, const MatrixView *C) {
+    ConstMatrixView padA[kLanes], padB[kLanes];
+    if (count < kLanes) {
+        for (int l = 0; l < kLanes; ++l) {
+            padA[l] = A[l < count ? l : count - 1];
+            padB[l] = B[l < count ? l : count - 1];
+        }
+        A = padA;
+        B = padB;
+    }
+    Lanes a[Schedule::M * Schedule::K], b[Schedule::K * Schedule::N], c[Schedule::M * Schedule::N];
+    packLanes(A, Schedule::M, Schedule::K, a);
+    packLanes(B, Schedule::K, Schedule::N, b);
+    Schedule::run(a, b, c);
+    unpackLanes(c, count, Schedule::M, Schedule::N, C);
+}
+
+using GroupFn = void (*)(int m, int k, int n, int count, const ConstMatrixView *A, const ConstMatrixView *B,
+                         const MatrixView *C);
+
+// Te same jądra skompilowane dla każdego zestawu instrukcji (Simd.h)
+
+struct ScalarIsa {
+    template <int S>
+    static void run(int m, int k, int n, int count, const ConstMatrixView *A, const ConstMatrixView *B,
+                    const MatrixView *C) {
+        runGroup<S>(m, k, n, count, A, B, C);
+    }
+
+    template <class Schedule>
+    static void runSchedule(int count, const ConstMatrixView *A, const ConstMatrixView *B, const MatrixView *C) {
+        runScheduleGroup<Schedule>(count, A, B, C);
+    }
+};
+
+struct Avx2Isa {
+    template <int S>
+    SIMD_AVX2 static void run(int m, int k, int n, int count, const ConstMatrixView *A, const ConstMatrixView *B,
+                              const MatrixView *C) {
+        runGroup<S>(m, k, n, count, A, B, C);
+    }
+
+    template <class Schedule>
+    SIMD_AVX2 static void runSchedule(int count, const ConstMatrixView *A, const ConstMatrixView *B,
+                                      const MatrixView *C) {
+        runScheduleGroup<Schedule>(count, A, B, C);
+    }
+};
+
+struct Avx512Isa {
+    template <int S>
+    SIMD_AVX512 static void run(int m, int k, int n, int count, const ConstMatrixView *A,
+                                const ConstMatrixView *B, const MatrixView *C) {
+        runGroup<S>(m, k, n, count, A, B, C);
+    }
+
+    template <class Schedule>
+    SIMD_AVX512 static void runSchedule(int count, const ConstMatrixView *A, const ConstMatrixView *B,
+                                        const MatrixView *C) {
+        runScheduleGroup<Schedule>(count, A, B, C);
+    }
+};
+
+using ScheduleFn = void (*)(int count, const ConstMatrixView *A, const ConstMatrixView *B, const MatrixView *C);
+
+struct BatchedKernels {
+    std::array<GroupFn, kSmallGemmMax> square;  // square[s - 1] dla s x s * s x s
+    GroupFn dynamic;
+    ScheduleFn ai455;
+};
+
+template <typename Isa, std::size_t... S>
+BatchedKernels kernelsFor(std::index_sequence<S...>) {
+    return {{{&Isa::template run<static_cast<int>(S) + 1>...}}, &Isa::template run<0>,
+            &Isa::template runSchedule<AI455Schedule>};
+}
+
+const BatchedKernels &batchedKernels() {
+    static const BatchedKernels kernels = [] {
+        auto sizes = std::make_index_sequence<kSmallGemmMax>();
+        switch (simdIsa()) {
+            case SimdIsa::Avx512: return kernelsFor<Avx512Isa>(sizes);
+            case SimdIsa::Avx2: return kernelsFor<Avx2Isa>(sizes);
+            default: return kernelsFor<ScalarIsa>(sizes);
+        }
+    }();
+    return kernels;
+}
+
+} // namespace
+
+void gemmBatched(int count, const ConstMatrixView *A, const ConstMatrixView *B, const MatrixView *C) {
+    if (count <= 0) return;
+    int m = A[0].rows, k = A[0].cols, n = B[0].cols;
+    for (int i = 0; i < count; ++i) {
+        if (A[i].rows != m || A[i].cols != k || B[i].rows != k || B[i].cols != n || C[i].rows != m ||
+            C[i].cols != n) {
+            throw std::runtime_error("gemmBatched: all problems must have the same shape");
+        }
+    }
+    if (!isSmallGemm(m, k, n) || k == 0) {
+        for (int i = 0; i < count; ++i) gemm(A[i], B[i], C[i]);
+        return;
+    }
+    if (m == 0 || n == 0) return;
+
+    const BatchedKernels &kernels = batchedKernels();
+    GroupFn run = m == k && k == n ? kernels.square[m - 1] : kernels.dynamic;
+
+    for (int g = 0; g < count; g += kLanes) run(m, k, n, std::min(kLanes, count - g), A + g, B + g, C + g);
+
+    std::uint64_t mn = static_cast<std::uint64_t>(count) * m * n;
+    opCounterAdd({mn * (k - 1), 0, mn * k, 0});
+}
+
+void multiplyBatch(IMnozenie &multImpl, int count, const ConstMatrixView *A, const ConstMatrixView *B,
+                   const MatrixView *C) {
+    // Niepełna grupa liczy wszystkie kLanes pasów, więc przy kilku problemach
+    // opłaca się tylko dla najmniejszych rozmiarów (pomiar: pojedynczy do 4x4,
+    // para do 8x8, pełna grupa do 16x16)
+    int maxDim = count > 0 ? std::max({A[0].rows, A[0].cols, B[0].cols}) : 0;
+    if (count > 0 && isSmallGemm(A[0].rows, A[0].cols, B[0].cols) && 4 * count >= maxDim) {
+        gemmBatched(count, A, B, C);
+        return;
+    }
+    for (int i = 0; i < count; ++i) multImpl.multiplyInto(A[i], B[i], C[i]);
+}
+
+void multiplySmall(IMnozenie &multImpl, ConstMatrixView A, ConstMatrixView B, MatrixView C) {
+    multiplyBatch(multImpl, 1, &A, &B, &C);
+}
+
+void multiplyAddSmall(IMnozenie &multImpl, MatrixView C, double alpha, ConstMatrixView A, ConstMatrixView B,
+                      double beta) {
+    if (isSmallGemm(A.rows, A.cols, B.cols)) gemm(C, alpha, A, B, beta);
+    else multImpl.multiplyAdd(C, alpha, A, B, beta);
+}
+
+void aiBatched(int count, const ConstMatrixView *A, const ConstMatrixView *B, const MatrixView *C) {
+    for (int i = 0; i < count; ++i) {
+        if (A[i].rows != 4 || A[i].cols != 5 || B[i].rows != 5 || B[i].cols != 5 || C[i].rows != 4 ||
+            C[i].cols != 5) {
+            throw std::runtime_error("aiBatched: all problems must be 4x5 * 5x5");
+        }
+    }
+    if (count <= 0) return;
+
+    ScheduleFn run = batchedKernels().ai455;
+    for (int g = 0; g < count; g += kLanes) run(std::min(kLanes, count - g), A + g, B + g, C + g);
+
+    std::uint64_t n = static_cast<std::uint64_t>(count);
+    opCounterAdd({n * AI455Schedule::adds, n * AI455Schedule::subs, n * AI455Schedule::muls, 0});
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <functional>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+/**
+ * Wspólny szkielet pomiarów czasu (bench.cpp).
+ *
+ * Każdy przypadek uruchamiany jest warmup razy bez pomiaru, a potem
+ * repetitions razy z pomiarem; wynik to statystyki z wszystkich powtórzeń
+ * zamiast pojedynczego czasu, który przy jednym uruchomieniu za bardzo skacze.
+ */
+struct BenchConfig {
+    int warmup = 2;
+    int repetitions = 10;
+    int cpu = -1;                // rdzeń, do którego przypinany jest wątek (-1 = bez przypinania)
+    int threads = 1;             // rozmiar puli wątków (tam, gdzie algorytm go używa)
+    std::string format = "csv";  // csv albo json
+    std::string output;          // plik wynikowy, pusty = stdout
+    std::vector<int> sizes;      // argumenty pozycyjne
+};
+
+struct BenchResult {
+    std::string name;
+    int n = 0;
+    int warmup = 0;
+    int repetitions = 0;
+    double min = 0.0;     // czasy w sekundach
+    double median = 0.0;
+    double p90 = 0.0;
+    double mean = 0.0;
+    double stddev = 0.0;
+    double flops = 0.0;   // operacje zmiennoprzecinkowe jednego uruchomienia (0 = nieznane)
+    double gflops = 0.0;  // flops / median
+};
+
+// --warmup W --reps R --cpu C --threads T --format csv|json --out PLIK, reszta to rozmiary.
+// Rzuca std::runtime_error przy niepoprawnym argumencie.
+BenchConfig parseBenchArgs(int argc, char **argv, std::vector<int> defaultSizes);
+
+// Przypina bieżący wątek do rdzenia cpu; false gdy się nie udało
+bool pinCurrentThread(int cpu);
+
+BenchResult runBenchmark(const std::string &name, int n, const BenchConfig &config,
+                         const std::function<void()> &run, double flops);
+
+void writeBenchResults(std::ostream &out, const std::vector<BenchResult> &results, const std::string &format);
+
+// Zapis do config.output (albo na stdout) w formacie config.format
+void writeBenchResults(const BenchConfig &config, const std::vector<BenchResult> &results);
@@ -0,0 +1,340 @@
+#include "BilinearScheme.h"
+#include "Arena.h"
+#include "FixedKernels.h"
+#include "Gemm.h"
+#include "Schemes.h"
+#include "SupportFunctions.h"
+
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+
+// Największy wymiar schematu - indeksy bloków mieszczą się w jednej cyfrze
+constexpr int kMaxSchemeDim = 9;
+
+// Niepuste wiersze pliku jako listy tokenów
+std::vector<std::vector<std::string>> readTokens(const std::string &path) {
+    std::ifstream in(path);
+    if (!in.is_open()) throw std::runtime_error("Cannot open scheme file " + path);
+    std::vector<std::vector<std::string>> lines;
+    std::string line;
+    while (std::getline(in, line)) {
+        std::istringstream iss(line);
+        std::vector<std::string> tokens;
+        std::string token;
+        while (iss >> token) tokens.push_back(token);
+        if (!tokens.empty()) lines.push_back(tokens);
+    }
+    return lines;
+}
+
+// "-31" -> -1 i "31"
+int splitSign(const std::string &token, std::string &digits) {
+    int sign = token[0] == '-' ? -1 : 1;
+    digits = token[0] == '-' || token[0] == '+' ? token.substr(1) : token;
+    return sign;
+}
+
+// multa.txt / multb.txt: wiersz r to czynnik iloczynu r, token "ij" (od 1) to X[i-1][j-1]
+std::vector<int> readFactor(const std::string &path, int rows, int cols, int &rank) {
+    std::vector<std::vector<std::string>> lines = readTokens(path);
+    rank = static_cast<int>(lines.size());
+    std::vector<int> coef(lines.size() * rows * cols, 0);
+    for (std::size_t r = 0; r < lines.size(); ++r) {
+        for (const std::string &token : lines[r]) {
+            std::string digits;
+            int sign = splitSign(token, digits);
+            if (digits.size() != 2 || digits[0] < '1' || digits[0] - '0' > rows || digits[1] < '1' ||
+                digits[1] - '0' > cols) {
+                throw std::runtime_error("Bad term '" + token + "' in " + path);
+            }
+            coef[r * rows * cols + (digits[0] - '1') * cols + (digits[1] - '1')] += sign;
+        }
+    }
+    return coef;
+}
+
+// multc.txt: wiersz l to C[l % m][l / m], token "5" to h5 (od 1)
+std::vector<int> readOutputs(const std::string &path, int m, int n, int rank) {
+    std::vector<std::vector<std::string>> lines = readTokens(path);
+    if (static_cast<int>(lines.size()) != m * n) throw std::runtime_error("Wrong number of outputs in " + path);
+    std::vector<int> coef(static_cast<std::size_t>(m) * n * rank, 0);
+    for (int l = 0; l < m * n; ++l) {
+        for (const std::string &token : lines[l]) {
+            std::string digits;
+            int sign = splitSign(token, digits);
+            int r = 0;
+            for (char ch : digits) {
+                if (ch < '0' || ch > '9') throw std::runtime_error("Bad term '" + token + "' in " + path);
+                r = 10 * r + (ch - '0');
+            }
+            if (r < 1 || r > rank) throw std::runtime_error("Bad term '" + token + "' in " + path);
+            coef[((l % m) * n + l / m) * rank + (r - 1)] += sign;
+        }
+    }
+    return coef;
+}
+
+// Równania Brenta: sum_r U[r](i,p) V[r](p',j) W[r](i',j') = [p = p'][i = i'][j = j']
+void checkScheme(const BilinearScheme &s) {
+    int mk = s.m * s.k, kn = s.k * s.n, mn = s.m * s.n;
+    for (int a = 0; a < mk; ++a)
+        for (int b = 0; b < kn; ++b)
+            for (int o = 0; o < mn; ++o) {
+                long long t = 0;
+                for (int r = 0; r < s.rank; ++r) {
+                    t += static_cast<long long>(s.U[r * mk + a]) * s.V[r * kn + b] * s.W[o * s.rank + r];
+                }
+                bool expected = a % s.k == b / s.n && a / s.k == o / s.n && b % s.n == o % s.n;
+                if (t != (expected ? 1 : 0)) {
+                    throw std::runtime_error("Scheme " + s.name + " does not compute the matrix product");
+                }
+            }
+}
+
+template <class S>
+BilinearScheme fromTables(const std::string &name) {
+    BilinearScheme s;
+    s.name = name;
+    s.m = S::M;
+    s.k = S::K;
+    s.n = S::N;
+    s.rank = S::R;
+    for (int r = 0; r < S::R; ++r) {
+        for (int e = 0; e < S::M * S::K; ++e) s.U.push_back(S::u(r, e));
+        for (int e = 0; e < S::K * S::N; ++e) s.V.push_back(S::v(r, e));
+    }
+    for (int o = 0; o < S::M * S::N; ++o)
+        for (int r = 0; r < S::R; ++r) s.W.push_back(S::w(o, r));
+    return s;
+}
+
+// C = c * X (accumulate = false) albo C += c * X; +-1 bez mnożenia
+void scaledInto(MatrixView C, int c, ConstMatrixView X, bool accumulate) {
+    if (c == 1) {
+        if (accumulate) addAssign(C, X);
+        else copyInto(X, C);
+        return;
+    }
+    if (c == -1 && accumulate) {
+        subAssign(C, X);
+        return;
+    }
+    double cd = c;
+    for (int i = 0; i < C.rows; ++i) {
+        const double *Xi = X[i];
+        double *Ci = C[i];
+        if (c == -1) {
+            for (int j = 0; j < C.cols; ++j) Ci[j] = -Xi[j];
+        } else if (accumulate) {
+            for (int j = 0; j < C.cols; ++j) Ci[j] += cd * Xi[j];
+        } else {
+            for (int j = 0; j < C.cols; ++j) Ci[j] = cd * Xi[j];
+        }
+    }
+    std::uint64_t mn = static_cast<std::uint64_t>(C.rows) * C.cols;
+    if (c == -1) opCounterAdd({0, mn, 0, 0});
+    else opCounterAdd({accumulate && c > 0 ? mn : 0, accumulate && c < 0 ? mn : 0, mn, 0});
+}
+
+// sum_e coef[e] * block(e). Pojedynczy blok z +1 zwracany bez kopiowania,
+// inaczej suma w dest, od pierwszego dodatniego składnika (jak FixedKernels.h).
+template <class Block>
+ConstMatrixView combineBlocks(const int *coef, int size, const Block &block, MatrixView dest) {
+    int firstPositive = -1, firstNonzero = -1, count = 0;
+    for (int e = 0; e < size; ++e) {
+        if (coef[e] == 0) continue;
+        ++count;
+        if (firstNonzero < 0) firstNonzero = e;
+        if (firstPositive < 0 && coef[e] > 0) firstPositive = e;
+    }
+    if (count == 0) {
+        setZero(dest);
+        return dest;
+    }
+    int lead = firstPositive >= 0 ? firstPositive : firstNonzero;
+    if (count == 1 && coef[lead] == 1) return block(lead);
+
+    int second = -1;
+    for (int e = 0; e < size && second < 0; ++e) {
+        if (e != lead && coef[e] != 0) second = e;
+    }
+    if (coef[lead] == 1 && (coef[second] == 1 || coef[second] == -1)) {
+        if (coef[second] == 1) addInto(block(lead), block(second), dest);
+        else subInto(block(lead), block(second), dest);
+    } else {
+        scaledInto(dest, coef[lead], block(lead), false);
+        second = -1;
+    }
+    for (int e = 0; e < size; ++e) {
+        if (e != lead && e != second && coef[e] != 0) scaledInto(dest, coef[e], block(e), true);
+    }
+    return dest;
+}
+
+class SchemeImpl : public IMnozenie {
+public:
+    SchemeImpl(BilinearScheme scheme, int leafSize, SchemeEdges edges)
+        : s(std::move(scheme)), leafSize(leafSize), edges(edges) {
+        if (s.m < 1 || s.k < 1 || s.n < 1 || s.m * s.k * s.n == 1) {
+            throw std::runtime_error("Scheme " + s.name + " does not split any dimension");
+        }
+        // schemat złożony ręcznie (nie przez loadScheme) - started w multiplyLevel ma stały rozmiar
+        if (s.m > kMaxSchemeDim || s.k > kMaxSchemeDim || s.n > kMaxSchemeDim) {
+            throw std::invalid_argument("Scheme " + s.name + " dimensions must be at most 9");
+        }
+    }
+
+    void multiplyInto(ConstMatrixView A, ConstMatrixView B, MatrixView C) override {
+        if (A.cols != B.rows) throw std::runtime_error("Incompatible dimensions for multiplication");
+        Arena &arena = threadArena();
+        Arena::Scope scope(arena);
+        arena.reserve(scratchSize(A.rows, A.cols, B.cols));
+        multiplyRec(A, B, C);
+    }
+
+private:
+    BilinearScheme s;
+    int leafSize;
+    SchemeEdges edges;
+
+    bool isLeaf(int M, int K, int N) const {
+        return (M <= leafSize && K <= leafSize && N <= leafSize) || M < s.m || K < s.k || N < s.n;
+    }
+
+    static int roundUp(int x, int d) { return (x + d - 1) / d * d; }
+
+    // Elementy areny potrzebne rekurencji dla M x K * K x N
+    std::size_t scratchSize(int M, int K, int N) const {
+        if (isLeaf(M, K, N)) return 0;
+        std::size_t pad = 0;
+        if (edges == SchemeEdges::Pad) {
+            int Mp = roundUp(M, s.m), Kp = roundUp(K, s.k), Np = roundUp(N, s.n);
+            if (Mp != M || Kp != K || Np != N) {
+                pad = Arena::footprint(Mp, Kp) + Arena::footprint(Kp, Np) + Arena::footprint(Mp, Np);
+            }
+            M = Mp;
+            K = Kp;
+            N = Np;
+        }
+        int bm = M / s.m, bk = K / s.k, bn = N / s.n;
+        return pad + Arena::footprint(bm, bk) + Arena::footprint(bk, bn) + Arena::footprint(bm, bn) +
+               scratchSize(bm, bk, bn);
+    }
+
+    void multiplyRec(ConstMatrixView A, ConstMatrixView B, MatrixView C) {
+        int M = A.rows, K = A.cols, N = B.cols;
+        if (isLeaf(M, K, N)) {
+            if (isFixedShape(M, K, N)) fixedMultiplyInto(A, B, C);
+            else gemm(A, B, C);
+            return;
+        }
+
+        int Mc = M - M % s.m, Kc = K - K % s.k, Nc = N - N % s.n;
+        if (Mc == M && Kc == K && Nc == N) {
+            multiplyLevel(A, B, C);
+        } else if (edges == SchemeEdges::Pad) {
+            int Mp = roundUp(M, s.m), Kp = roundUp(K, s.k), Np = roundUp(N, s.n);
+            Arena &arena = threadArena();
+            Arena::Scope scope(arena);
+            MatrixView Ap = arena.allocate(Mp, Kp), Bp = arena.allocate(Kp, Np), Cp = arena.allocate(Mp, Np);
+            setZero(Ap);
+            setZero(Bp);
+            copyInto(A, Ap.block(0, 0, M, K));
+            copyInto(B, Bp.block(0, 0, K, N));
+            multiplyLevel(Ap, Bp, Cp);
+            copyInto(Cp.block(0, 0, M, N), C);
+        } else {
+            // rdzeń Mc x Kc * Kc x Nc schematem, reszta - paski wzdłuż brzegów
+            multiplyLevel(A.block(0, 0, Mc, Kc), B.block(0, 0, Kc, Nc), C.block(0, 0, Mc, Nc));
+            if (Kc < K) gemm(A.block(0, Kc, Mc, K - Kc), B.block(Kc, 0, K - Kc, Nc), C.block(0, 0, Mc, Nc), true);
+            if (Nc < N) gemm(A.block(0, 0, Mc, K), B.block(0, Nc, K, N - Nc), C.block(0, Nc, Mc, N - Nc));
+            if (Mc < M) gemm(A.block(Mc, 0, M - Mc, K), B, C.block(Mc, 0, M - Mc, N));
+        }
+    }
+
+    // Jeden poziom schematu; wymiary podzielne przez m, k, n
+    void multiplyLevel(ConstMatrixView A, ConstMatrixView B, MatrixView C) {
+        int bm = A.rows / s.m, bk = A.cols / s.k, bn = B.cols / s.n;
+        std::size_t hm = static_cast<std::size_t>(bm), hn = static_cast<std::size_t>(bn);
+        memCounterEnterCall(hm, hn, 3);
+
+        auto blockA = [&](int e) { return A.block(e / s.k * bm, e % s.k * bk, bm, bk); };
+        auto blockB = [&](int e) { return B.block(e / s.n * bk, e % s.n * bn, bk, bn); };
+        auto blockC = [&](int o) { return C.block(o / s.n * bm, o % s.n * bn, bm, bn); };
+
+        Arena &arena = threadArena();
+        Arena::Scope scope(arena);
+        MatrixView SA = arena.allocate(bm, bk), SB = arena.allocate(bk, bn), P = arena.allocate(bm, bn);
+
+        int mn = s.m * s.n;
+        char started[kMaxSchemeDim * kMaxSchemeDim] = {};
+        for (int r = 0; r < s.rank; ++r) {
+            ConstMatrixView a = combineBlocks(&s.U[r * s.m * s.k], s.m * s.k, blockA, SA);
+            ConstMatrixView b = combineBlocks(&s.V[r * s.k * s.n], s.k * s.n, blockB, SB);
+
+            // iloczyn trafiający tylko do jednego, jeszcze pustego bloku C
+            // z współczynnikiem +1 liczony jest od razu w tym bloku
+            int target = -1, uses = 0;
+            for (int o = 0; o < mn; ++o) {
+                if (s.W[o * s.rank + r] != 0) {
+                    target = o;
+                    ++uses;
+                }
+            }
+            if (uses == 0) continue;
+            if (uses == 1 && s.W[target * s.rank + r] == 1 && !started[target]) {
+                multiplyRec(a, b, blockC(target));
+                started[target] = 1;
+                continue;
+            }
+
+            multiplyRec(a, b, P);
+            for (int o = 0; o < mn; ++o) {
+                int w = s.W[o * s.rank + r];
+                if (w == 0) continue;
+                scaledInto(blockC(o), w, P, started[o]);
+                started[o] = 1;
+            }
+        }
+        for (int o = 0; o < mn; ++o) {
+            if (!started[o]) setZero(blockC(o));
+        }
+
+        memCounterExitCall(hm, hn, 3);
+    }
+};
+
+} // namespace
+
+BilinearScheme loadScheme(const std::string &dir, int m, int k, int n) {
+    if (m < 1 || k < 1 || n < 1 || m > kMaxSchemeDim || k > kMaxSchemeDim || n > kMaxSchemeDim) {
+        throw std::runtime_error("Scheme dimensions must be between 1 and 9");
+    }
+    BilinearScheme s;
+    s.name = dir;
+    s.m = m;
+    s.k = k;
+    s.n = n;
+    int rankA = 0, rankB = 0;
+    s.U = readFactor(dir + "/multa.txt", m, k, rankA);
+    s.V = readFactor(dir + "/multb.txt", k, n, rankB);
+    if (rankA != rankB || rankA == 0) throw std::runtime_error("multa.txt and multb.txt differ in rank in " + dir);
+    s.rank = rankA;
+    s.W = readOutputs(dir + "/multc.txt", m, n, s.rank);
+    checkScheme(s);
+    return s;
+}
+
+BilinearScheme builtinScheme(const std::string &name) {
+    if (name == "strassen") return fromTables<Strassen222>(name);
+    if (name == "laderman") return fromTables<Laderman333>(name);
+    if (name == "ai455") return fromTables<AI455>(name);
+    throw std::runtime_error("Unknown scheme: " + name);
+}
+
+std::unique_ptr<IMnozenie> createScheme(BilinearScheme scheme, int leafSize, SchemeEdges edges) {
+    return std::make_unique<SchemeImpl>(std::move(scheme), leafSize, edges);
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include "Mnozenie.h"
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * Schemat dwuliniowy <m, k, n; rank>: iloczyn macierzy m x k i k x n
+ * z rank mnożeń, C = W * ((U a) .* (V b)), a i b - elementy A i B wierszami.
+ *
+ * Współczynniki są całkowite; U[r * m * k + i * k + p] to współczynnik
+ * A[i][p] w lewym czynniku iloczynu r, V[r * k * n + p * n + j] - B[p][j]
+ * w prawym, W[(i * n + j) * rank + r] - iloczynu r w C[i][j] (jak w Schemes.h).
+ */
+struct BilinearScheme {
+    std::string name;
+    int m = 0, k = 0, n = 0, rank = 0;
+    std::vector<int> U, V, W;
+};
+
+// Wczytuje multa.txt, multb.txt i multc.txt z katalogu dir (format
+// AIutils/tocpp.py) jako schemat <m, k, n> i sprawdza, że naprawdę liczy
+// iloczyn (równania Brenta). Błędy - std::runtime_error.
+BilinearScheme loadScheme(const std::string &dir, int m, int k, int n);
+
+// Schematy z Schemes.h: "strassen" <2,2,2;7>, "laderman" <3,3,3;23>,
+// "ai455" <4,5,5;76>. Nieznana nazwa - std::runtime_error.
+BilinearScheme builtinScheme(const std::string &name);
+
+// Co zrobić z wymiarem niepodzielnym przez wymiar schematu na danym poziomie
+enum class SchemeEdges {
+    Peel, // rdzeń podzielny schematem, brzegi (wiersze/kolumny reszty) blokowym gemm
+    Pad   // dopełnienie zerami do wielokrotności (kopie w arenie)
+};
+
+/**
+ * Fabryka zwracająca implementację IMnozenie, która stosuje schemat
+ * rekurencyjnie do macierzy dowolnego kształtu: każdy poziom dzieli A, B
+ * i C na bloki m x k, k x n, m x n i liczy rank iloczynów bloków kolejnym
+ * poziomem. Podproblem, w którym wszystkie wymiary są <= leafSize albo
+ * któryś jest mniejszy niż wymiar schematu, liczy blokowy gemm (do 4x4 -
+ * jądro z FixedKernels.h). Bufory pomocnicze (suma bloków A, suma bloków B,
+ * iloczyn) pochodzą z areny wątku - trzy na poziom. Wymiary schematu, jak
+ * w loadScheme, co najwyżej 9 (inaczej std::invalid_argument).
+ */
+std::unique_ptr<IMnozenie> createScheme(BilinearScheme scheme, int leafSize = 64,
+                                        SchemeEdges edges = SchemeEdges::Peel);
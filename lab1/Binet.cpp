@@ -1,5 +1,8 @@
 #include "Binet.h"
 #include "SupportFunctions.h"
+#include "Gemm.h"
+#include "ThreadPool.h"
+#include "FixedKernels.h"
 
 #include <algorithm>
 #include <stdexcept>
@@ -8,23 +11,35 @@
 
 namespace {
 
-using Matrix = ::Matrix;
-
-Matrix multiplyRec(const Matrix &A, const Matrix &B) {
-    int Arows = static_cast<int>(A.size());
-    int Acols = Arows ? static_cast<int>(A[0].size()) : 0;
-    int Brows = static_cast<int>(B.size());
-    int Bcols = Brows ? static_cast<int>(B[0].size()) : 0;
+// C = op(A) * op(B) (accumulate = false) albo C += op(A) * op(B) (accumulate = true),
+// każdy iloczyn w liściu mnożony przez form.alpha.
+// Ćwiartki A, B i C są widokami na oryginalne bufory - nic nie jest kopiowane.
+// Przy parallelDepth > 0 cztery ćwiartki C liczone są jako osobne zadania
+// puli wątków (każde pisze do innej ćwiartki, więc nie ma wyścigów).
+void multiplyRec(ConstMatrixView A, ConstMatrixView B, MatrixView C, bool accumulate, const GemmForm &form,
+                 int leafSize, int parallelDepth) {
+    int Arows = opRows(A, form.opA);
+    int Acols = opCols(A, form.opA);
+    int Brows = opRows(B, form.opB);
+    int Bcols = opCols(B, form.opB);
     if (Acols != Brows) {
         throw std::runtime_error("Incompatible dimensions for multiplication");
     }
 
     if (Arows == 1 || Acols == 1 || Bcols == 1) {
-        Matrix M = A * B;
-        return M;
+        if (form.plain()) multiplyInto(A, B, C, accumulate);
+        else gemm(C, form, A, B, accumulate);
+        return;
+    }
+    if (Arows <= leafSize && Acols <= leafSize && Bcols <= leafSize) {
+        // najmniejsze liście - jądra rozwinięte w czasie kompilacji (FixedKernels.h)
+        if (form.plain() && isFixedShape(Arows, Acols, Bcols)) fixedMultiplyInto(A, B, C, accumulate);
+        else gemm(C, form, A, B, accumulate);
+        return;
     }
 
-    memCounterEnterCall(static_cast<std::size_t>(Arows), static_cast<std::size_t>(Bcols), 3);
+    // brak tymczasowych macierzy - liczymy tylko wywołania rekurencyjne
+    memCounterEnterCall(static_cast<std::size_t>(Arows), static_cast<std::size_t>(Bcols), 0);
 
     int A11width = Acols / 2;
     int A12width = Acols - A11width;
@@ -34,25 +49,30 @@ Matrix multiplyRec(const Matrix &A, const Matrix &B) {
     int B11width = Bcols / 2;
     int B12width = Bcols - B11width;
     
-    Matrix A11 = subMatrix(A, 0, 0, A11height, A11width);
-    Matrix A12 = subMatrix(A, 0, A11width, A11height, A12width);
-    Matrix A21 = subMatrix(A, A11height, 0, A21height, A11width);
-    Matrix A22 = subMatrix(A, A11height, A11width, A21height, A12width);
-
-    Matrix B11 = subMatrix(B, 0, 0, A11width, B11width);
-    Matrix B12 = subMatrix(B, 0, B11width, A11width, B12width);
-    Matrix B21 = subMatrix(B, A11width, 0, A12width, B11width);
-    Matrix B22 = subMatrix(B, A11width, B11width, A12width, B12width);
-
-    Matrix C11 = multiplyRec(A11, B11) + multiplyRec(A12, B21);
-    Matrix C12 = multiplyRec(A11, B12) + multiplyRec(A12, B22);
-    Matrix C21 = multiplyRec(A21, B11) + multiplyRec(A22, B21);
-    Matrix C22 = multiplyRec(A21, B12) + multiplyRec(A22, B22);
-
-    Matrix M = combine(C11, C12, C21, C22);
-
-    memCounterExitCall(static_cast<std::size_t>(Arows), static_cast<std::size_t>(Bcols), 3);
-    return M;
+    ConstMatrixView A11 = opBlock(A, form.opA, 0, 0, A11height, A11width);
+    ConstMatrixView A12 = opBlock(A, form.opA, 0, A11width, A11height, A12width);
+    ConstMatrixView A21 = opBlock(A, form.opA, A11height, 0, A21height, A11width);
+    ConstMatrixView A22 = opBlock(A, form.opA, A11height, A11width, A21height, A12width);
+
+    ConstMatrixView B11 = opBlock(B, form.opB, 0, 0, A11width, B11width);
+    ConstMatrixView B12 = opBlock(B, form.opB, 0, B11width, A11width, B12width);
+    ConstMatrixView B21 = opBlock(B, form.opB, A11width, 0, A12width, B11width);
+    ConstMatrixView B22 = opBlock(B, form.opB, A11width, B11width, A12width, B12width);
+
+    MatrixView C11 = C.block(0, 0, A11height, B11width);
+    MatrixView C12 = C.block(0, B11width, A11height, B12width);
+    MatrixView C21 = C.block(A11height, 0, A21height, B11width);
+    MatrixView C22 = C.block(A11height, B11width, A21height, B12width);
+
+    int d = parallelDepth > 0 ? parallelDepth - 1 : 0;
+    TaskGroup group(parallelDepth > 0 ? &threadPool() : nullptr);
+    group.run([&] { multiplyRec(A11, B11, C11, accumulate, form, leafSize, d); multiplyRec(A12, B21, C11, true, form, leafSize, d); });
+    group.run([&] { multiplyRec(A11, B12, C12, accumulate, form, leafSize, d); multiplyRec(A12, B22, C12, true, form, leafSize, d); });
+    group.run([&] { multiplyRec(A21, B11, C21, accumulate, form, leafSize, d); multiplyRec(A22, B21, C21, true, form, leafSize, d); });
+    group.run([&] { multiplyRec(A21, B12, C22, accumulate, form, leafSize, d); multiplyRec(A22, B22, C22, true, form, leafSize, d); });
+    group.wait();
+
+    memCounterExitCall(static_cast<std::size_t>(Arows), static_cast<std::size_t>(Bcols), 0);
 }
 
 } // namespace (internal)
@@ -60,12 +80,36 @@ Matrix multiplyRec(const Matrix &A, const Matrix &B) {
 
 class BinetImpl : public IMnozenie {
 public:
-    Matrix multiply(const Matrix &A, const Matrix &B) override {
-        return multiplyRec(A, B);
+    BinetImpl(int leafSize, int parallelDepth) : leafSize(leafSize), parallelDepth(parallelDepth) {}
+
+    void multiplyInto(ConstMatrixView A, ConstMatrixView B, MatrixView C) override {
+        multiplyRec(A, B, C, false, GemmForm{}, leafSize, parallelDepth);
     }
+
+    // beta skalowane raz z góry, dalej ćwiartki C akumulują wprost. alpha = -1
+    // to w liściach odejmowania zamiast dodawań; inne alpha bez akumulacji
+    // mnoży gotowe C (raz na element, nie w każdym liściu).
+    void multiplyAdd(MatrixView C, double alpha, ConstMatrixView A, ConstMatrixView B, double beta,
+                     Op opA, Op opB) override {
+        if (alpha == 0.0) {
+            scaleAssign(C, beta);
+            return;
+        }
+        if (beta == 0.0 && alpha != 1.0 && alpha != -1.0) {
+            multiplyRec(A, B, C, false, GemmForm{opA, opB, 1.0}, leafSize, parallelDepth);
+            scaleAssign(C, alpha);
+            return;
+        }
+        if (beta != 0.0) scaleAssign(C, beta);
+        multiplyRec(A, B, C, beta != 0.0, GemmForm{opA, opB, alpha}, leafSize, parallelDepth);
+    }
+
+private:
+    int leafSize;
+    int parallelDepth;
 };
 
-std::unique_ptr<IMnozenie> createBinet() {
-    return std::make_unique<BinetImpl>();
+std::unique_ptr<IMnozenie> createBinet(int leafSize, int parallelDepth) {
+    return std::make_unique<BinetImpl>(leafSize, parallelDepth);
 }
 
@@ -7,6 +7,12 @@
  * Fabryka zwracająca implementację IMnozenie opartą o rekurencyjne mnożenie
  * (Binet / divide and conquer bez pad'owania).
  *
+ * Gdy każdy wymiar podproblemu jest <= leafSize, rekurencja kończy się
+ * wywołaniem blokowego gemm (liście do 4x4 - jądrem z FixedKernels.h);
+ * leafSize <= 1 daje rekurencję aż do 1x1.
+ * Pierwsze parallelDepth poziomów rekurencji wykonywane jest równolegle
+ * w puli wątków (threadPool()); 0 oznacza wersję sekwencyjną.
+ *
  * Deklaracja tutaj umożliwia użycie implementacji bez ujawniania szczegółów.
  */
-std::unique_ptr<IMnozenie> createBinet();
\ No newline at end of file
+std::unique_ptr<IMnozenie> createBinet(int leafSize = 64, int parallelDepth = 0);
@@ -0,0 +1,275 @@
+#pragma once
+
+#include "Matrix.h"
+#include "Schemes.h"
+#include "SupportFunctions.h"
+
+#include <stdexcept>
+#include <utility>
+
+/**
+ * Jądra mnożenia o stałym rozmiarze M x K * K x N, generowane w czasie
+ * kompilacji z tablic współczynników schematu dwuliniowego (Schemes.h,
+ * AIutils/toscheme.py): C = W * ((U a) .* (V b)).
+ *
+ * Schemat S to typ ze stałymi M, K, N, R i funkcjami constexpr u(r, e),
+ * v(r, e), w(o, r). Każda kombinacja liniowa jest w pełni rozwinięta: zerowe
+ * współczynniki znikają, +-1 nie wymaga mnożenia, a suma zaczyna się od
+ * pierwszego dodatniego składnika (negacja tylko gdy wszystkie są ujemne).
+ * Liczba operacji wynika z tablic i jest liczona w czasie kompilacji.
+ *
+ * Dostępne schematy: Strassen222, Laderman333 i AI455 (Schemes.h), ClassicalScheme<M, K, N>
+ * (zwykłe M*K*N iloczynów) i Nested<Outer, Inner> - Outer na blokach, których
+ * iloczyny liczy Inner (np. 4x4 jako Strassen ze Strassenem w blokach 2x2,
+ * z operacjami identycznymi jak dwa poziomy rekurencji).
+ */
+
+// klasyczne mnożenie jako schemat: iloczyn r = (i * K + p) * N + j to A[i][p] * B[p][j]
+template <int M_, int K_, int N_>
+struct ClassicalScheme {
+    static constexpr int M = M_, K = K_, N = N_, R = M * K * N;
+    static constexpr int u(int r, int e) { return e == r / (K * N) * K + r / N % K; }
+    static constexpr int v(int r, int e) { return e == r / N % K * N + r % N; }
+    static constexpr int w(int o, int r) { return o == r / (K * N) * N + r % N; }
+};
+
+// schemat Outer, w którym każdy element jest blokiem Inner::M x Inner::K (itd.)
+template <class Outer, class Inner>
+struct Nested {
+    static constexpr int M = Outer::M * Inner::M, K = Outer::K * Inner::K, N = Outer::N * Inner::N;
+    static constexpr int R = Outer::R * Inner::R;
+};
+
+namespace detail {
+
+enum class Factor { U, V, W };
+
+// Wiersz row tablicy U, V albo W schematu S
+template <class S, Factor F, int row>
+struct Row {
+    static constexpr int size = F == Factor::U ? S::M * S::K : F == Factor::V ? S::K * S::N : S::R;
+    static constexpr int at(int e) {
+        return F == Factor::U ? S::u(row, e) : F == Factor::V ? S::v(row, e) : S::w(row, e);
+    }
+};
+
+// Pierwszy składnik sumy: pierwszy dodatni, a gdy wszystkie są ujemne -
+// pierwszy niezerowy; -1 dla pustego wiersza
+template <class R>
+constexpr int leadTerm() {
+    int lead = -1;
+    for (int e = 0; e < R::size; ++e) {
+        if (R::at(e) > 0) return e;
+        if (R::at(e) < 0 && lead < 0) lead = e;
+    }
+    return lead;
+}
+
+template <int c>
+inline double leadValue(double x) {
+    if constexpr (c == 1) return x;
+    else if constexpr (c == -1) return -x;
+    else return c * x;
+}
+
+template <int c, class Get>
+inline __attribute__((always_inline)) double addTerm(double acc, const Get &get, int e) {
+    if constexpr (c == 0) return acc;
+    else if constexpr (c == 1) return acc + get(e);
+    else if constexpr (c == -1) return acc - get(e);
+    else if constexpr (c > 0) return acc + c * get(e);
+    else return acc - (-c) * get(e);
+}
+
+// sum_e R::at(e) * get(e) rozwinięte w czasie kompilacji
+template <class R, class Get, std::size_t... E>
+inline __attribute__((always_inline)) double combine(const Get &get, std::index_sequence<E...>) {
+    constexpr int lead = leadTerm<R>();
+    if constexpr (lead < 0) {
+        return 0.0;
+    } else {
+        double acc = leadValue<R::at(lead)>(get(lead));
+        ((acc = addTerm<static_cast<int>(E) == lead ? 0 : R::at(static_cast<int>(E))>(acc, get,
+                                                                                     static_cast<int>(E))),
+         ...);
+        return acc;
+    }
+}
+
+template <class R, class Get>
+inline __attribute__((always_inline)) double combine(const Get &get) {
+    return combine<R>(get, std::make_index_sequence<R::size>());
+}
+
+// Koszt combine dla wiersza: +-1 bez mnożenia, negacja tylko pierwszego składnika
+template <class S, Factor F>
+constexpr OpCounts factorOps(int row, int size) {
+    OpCounts ops{};
+    int lead = -1;
+    for (int e = 0; e < size && lead < 0; ++e) {
+        int c = F == Factor::U ? S::u(row, e) : F == Factor::V ? S::v(row, e) : S::w(row, e);
+        if (c > 0) lead = e;
+    }
+    for (int e = 0; e < size; ++e) {
+        int c = F == Factor::U ? S::u(row, e) : F == Factor::V ? S::v(row, e) : S::w(row, e);
+        if (c == 0) continue;
+        if (lead < 0) lead = e;
+        if (c != 1 && c != -1) ++ops.muls;
+        if (e == lead) {
+            if (c == -1) ++ops.subs;
+        } else if (c > 0) {
+            ++ops.adds;
+        } else {
+            ++ops.subs;
+        }
+    }
+    return ops;
+}
+
+constexpr OpCounts plusOps(OpCounts a, OpCounts b, std::uint64_t times = 1) {
+    return {a.adds + times * b.adds, a.subs + times * b.subs, a.muls + times * b.muls, a.divs + times * b.divs};
+}
+
+// Sumy po wierszach U, V i W (każdy wiersz liczony `times` razy)
+template <class S>
+constexpr OpCounts combineOps(std::uint64_t uvTimesA, std::uint64_t uvTimesB, std::uint64_t wTimes) {
+    OpCounts ops{};
+    for (int r = 0; r < S::R; ++r) {
+        ops = plusOps(ops, factorOps<S, Factor::U>(r, S::M * S::K), uvTimesA);
+        ops = plusOps(ops, factorOps<S, Factor::V>(r, S::K * S::N), uvTimesB);
+    }
+    for (int o = 0; o < S::M * S::N; ++o) ops = plusOps(ops, factorOps<S, Factor::W>(o, S::R), wTimes);
+    return ops;
+}
+
+} // namespace detail
+
+// a (M x K), b (K x N) i c (M x N) spakowane wierszami; c nie może nachodzić na a, b
+template <class S>
+struct SchemeKernel {
+    static constexpr int M = S::M, K = S::K, N = S::N;
+
+    static inline __attribute__((always_inline)) void run(const double *a, const double *b, double *c) {
+        double h[S::R];
+        products(a, b, h, std::make_index_sequence<S::R>());
+        outputs(h, c, std::make_index_sequence<M * N>());
+    }
+
+    static constexpr OpCounts ops() {
+        OpCounts products{0, 0, static_cast<std::uint64_t>(S::R), 0};
+        return detail::plusOps(products, detail::combineOps<S>(1, 1, 1));
+    }
+
+private:
+    template <std::size_t... r>
+    static inline __attribute__((always_inline)) void products(const double *a, const double *b, double *h,
+                                                               std::index_sequence<r...>) {
+        using detail::Factor;
+        ((h[r] = detail::combine<detail::Row<S, Factor::U, r>>([a](int e) { return a[e]; }) *
+                 detail::combine<detail::Row<S, Factor::V, r>>([b](int e) { return b[e]; })),
+         ...);
+    }
+
+    template <std::size_t... o>
+    static inline __attribute__((always_inline)) void outputs(const double *h, double *c,
+                                                              std::index_sequence<o...>) {
+        ((c[o] = detail::combine<detail::Row<S, detail::Factor::W, o>>([h](int r) { return h[r]; })), ...);
+    }
+};
+
+// Kombinacje Outer liczone element po elemencie bloków, iloczyny bloków - jądrem Inner
+template <class Outer, class Inner>
+struct SchemeKernel<Nested<Outer, Inner>> {
+    static constexpr int M = Outer::M * Inner::M, K = Outer::K * Inner::K, N = Outer::N * Inner::N;
+
+    static inline __attribute__((always_inline)) void run(const double *a, const double *b, double *c) {
+        double h[Outer::R][Inner::M * Inner::N];
+        products(a, b, h, std::make_index_sequence<Outer::R>());
+        outputs(h, c, std::make_index_sequence<Outer::M * Outer::N>());
+    }
+
+    static constexpr OpCounts ops() {
+        OpCounts blocks = detail::combineOps<Outer>(Inner::M * Inner::K, Inner::K * Inner::N, Inner::M * Inner::N);
+        return detail::plusOps(blocks, SchemeKernel<Inner>::ops(), Outer::R);
+    }
+
+private:
+    // indeks elementu e bloku blk macierzy rows x cols podzielonej na bloki br x bc
+    template <int cols, int br, int bc>
+    static constexpr int at(int blk, int e) {
+        return (blk / (cols / bc) * br + e / bc) * cols + blk % (cols / bc) * bc + e % bc;
+    }
+
+    template <std::size_t r>
+    static inline __attribute__((always_inline)) void product(const double *a, const double *b, double *hr) {
+        using detail::Factor;
+        double sa[Inner::M * Inner::K], sb[Inner::K * Inner::N];
+        for (int e = 0; e < Inner::M * Inner::K; ++e) {
+            sa[e] = detail::combine<detail::Row<Outer, Factor::U, r>>(
+                [a, e](int blk) { return a[at<K, Inner::M, Inner::K>(blk, e)]; });
+        }
+        for (int e = 0; e < Inner::K * Inner::N; ++e) {
+            sb[e] = detail::combine<detail::Row<Outer, Factor::V, r>>(
+                [b, e](int blk) { return b[at<N, Inner::K, Inner::N>(blk, e)]; });
+        }
+        SchemeKernel<Inner>::run(sa, sb, hr);
+    }
+
+    template <std::size_t... r>
+    static inline __attribute__((always_inline)) void products(const double *a, const double *b,
+                                                               double (*h)[Inner::M * Inner::N],
+                                                               std::index_sequence<r...>) {
+        (product<r>(a, b, h[r]), ...);
+    }
+
+    template <std::size_t o>
+    static inline __attribute__((always_inline)) void output(const double (*h)[Inner::M * Inner::N], double *c) {
+        for (int e = 0; e < Inner::M * Inner::N; ++e) {
+            c[at<N, Inner::M, Inner::N>(static_cast<int>(o), e)] =
+                detail::combine<detail::Row<Outer, detail::Factor::W, o>>([h, e](int r) { return h[r][e]; });
+        }
+    }
+
+    template <std::size_t... o>
+    static inline __attribute__((always_inline)) void outputs(const double (*h)[Inner::M * Inner::N], double *c,
+                                                              std::index_sequence<o...>) {
+        (output<o>(h, c), ...);
+    }
+};
+
+// C = A * B (accumulate = false) albo C += A * B (accumulate = true) schematem S.
+// Wymiary muszą być dokładnie S::M x S::K * S::K x S::N (inaczej std::runtime_error).
+template <class S>
+void schemeMultiplyInto(ConstMatrixView A, ConstMatrixView B, MatrixView C, bool accumulate = false) {
+    constexpr int M = SchemeKernel<S>::M, K = SchemeKernel<S>::K, N = SchemeKernel<S>::N;
+    if (A.rows != M || A.cols != K || B.rows != K || B.cols != N || C.rows != M || C.cols != N) {
+        throw std::runtime_error("schemeMultiplyInto: dimensions do not match the scheme");
+    }
+
+    double a[M * K], b[K * N], c[M * N];
+    for (int i = 0; i < M; ++i)
+        for (int p = 0; p < K; ++p) a[i * K + p] = A[i][p];
+    for (int p = 0; p < K; ++p)
+        for (int j = 0; j < N; ++j) b[p * N + j] = B[p][j];
+
+    SchemeKernel<S>::run(a, b, c);
+
+    for (int i = 0; i < M; ++i) {
+        double *Ci = C[i];
+        for (int j = 0; j < N; ++j) Ci[j] = accumulate ? Ci[j] + c[i * N + j] : c[i * N + j];
+    }
+
+    constexpr OpCounts ops = SchemeKernel<S>::ops();
+    opCounterAdd({ops.adds + (accumulate ? static_cast<std::uint64_t>(M) * N : 0), ops.subs, ops.muls, ops.divs});
+}
+
+// Klasyczne jądra ClassicalScheme dla wszystkich kształtów o wymiarach 1..kFixedMax
+constexpr int kFixedMax = 4;
+
+inline bool isFixedShape(int m, int k, int n) {
+    return m >= 1 && k >= 1 && n >= 1 && m <= kFixedMax && k <= kFixedMax && n <= kFixedMax;
+}
+
+// Jak schemeMultiplyInto<ClassicalScheme<m, k, n>>, z kształtem w czasie wykonania
+// (isFixedShape musi być spełnione)
+void fixedMultiplyInto(ConstMatrixView A, ConstMatrixView B, MatrixView C, bool accumulate = false);
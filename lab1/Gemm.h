@@ -0,0 +1,51 @@
+#pragma once
+
+#include "Mnozenie.h"
+#include <memory>
+
+/**
+ * Blokowe mnożenie macierzy w stylu GotoBLAS.
+ *
+ * B jest pakowane w panele kc x nc (L3), A w bloki mc x kc (L2), a mikrojądro
+ * liczy kafel MR x NR wyniku w rejestrach, czytając panel B o szerokości NR
+ * z L1. Rozmiary bloków wyznaczane są raz, na podstawie rozmiarów cache
+ * zgłaszanych przez system (z rozsądnymi wartościami domyślnymi).
+ */
+struct GemmBlocking {
+    int mc;
+    int kc;
+    int nc;
+};
+
+GemmBlocking gemmBlocking();
+
+// C = A * B (accumulate = false) albo C += A * B (accumulate = true)
+void gemm(ConstMatrixView A, ConstMatrixView B, MatrixView C, bool accumulate = false);
+
+// C = alpha * op(A) * op(B) + beta * C. Transpozycje i alpha obsługiwane są
+// przy pakowaniu paneli (bez kopii wejść), beta spoza {0, 1} - jednym
+// przeskalowaniem C przed akumulacją.
+void gemm(MatrixView C, double alpha, ConstMatrixView A, ConstMatrixView B, double beta,
+          Op opA = Op::NoTrans, Op opB = Op::NoTrans);
+
+// op(A), op(B) i alpha przekazywane w dół rekurencji Binet / Strassen / Winograd.
+// Bloki i sumy bloków op(A) są widokami / buforami w układzie A, więc opA
+// dotyczy ich wszystkich; alpha mnoży każdy iloczyn w liściu.
+struct GemmForm {
+    Op opA = Op::NoTrans;
+    Op opB = Op::NoTrans;
+    double alpha = 1.0;
+
+    // zwykłe A * B - można użyć jąder bez transpozycji i alpha (FixedKernels.h)
+    bool plain() const { return opA == Op::NoTrans && opB == Op::NoTrans && alpha == 1.0; }
+};
+
+// C = form.alpha * op(A) * op(B) (accumulate = false) albo C += ... (accumulate = true)
+inline void gemm(MatrixView C, const GemmForm &form, ConstMatrixView A, ConstMatrixView B, bool accumulate) {
+    gemm(C, form.alpha, A, B, accumulate ? 1.0 : 0.0, form.opA, form.opB);
+}
+
+/**
+ * Fabryka zwracająca implementację IMnozenie opartą bezpośrednio o gemm.
+ */
+std::unique_ptr<IMnozenie> createGemm();
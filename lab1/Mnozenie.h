@@ -1,16 +1,36 @@
 #pragma once
-#include <vector>
+#include "Matrix.h"
 #include <memory>
 
-using Matrix = std::vector<std::vector<double>>;
+// op(X) w multiplyAdd: X albo jego transpozycja
+enum class Op { NoTrans, Trans };
+
+// Wymiary op(X) i blok op(X)[row.., col..] jako widok na X - dla Op::Trans to
+// blok (col, row) transpozycji, nic nie jest kopiowane
+inline int opRows(ConstMatrixView X, Op op) { return op == Op::Trans ? X.cols : X.rows; }
+inline int opCols(ConstMatrixView X, Op op) { return op == Op::Trans ? X.rows : X.cols; }
+
+template <typename T>
+BasicMatrixView<T> opBlock(BasicMatrixView<T> X, Op op, int row, int col, int nrows, int ncols) {
+    return op == Op::Trans ? X.block(col, row, ncols, nrows) : X.block(row, col, nrows, ncols);
+}
 
 struct IMnozenie {
-    virtual Matrix multiply(const Matrix& A, const Matrix& B) = 0;
-    virtual ~IMnozenie() = default;
-};
+    // C = A * B, wynik zapisywany w miejscu do widoku C (rows(A) x cols(B))
+    virtual void multiplyInto(ConstMatrixView A, ConstMatrixView B, MatrixView C) = 0;
 
-// factory tworząca implementację Binet'a (zdefiniowana w Binet.cpp)
-std::unique_ptr<IMnozenie> createBinet();
+    // C = alpha * op(A) * op(B) + beta * C w miejscu (jak GEMM w BLAS).
+    // beta == 0 nadpisuje C bez czytania go. Wersja domyślna (Mnozenie.cpp)
+    // transponuje wejścia i liczy iloczyn w buforach areny, a potem dodaje go
+    // do C; backendy rekurencyjne i gemm nadpisują ją bez buforów na wynik.
+    virtual void multiplyAdd(MatrixView C, double alpha, ConstMatrixView A, ConstMatrixView B, double beta,
+                             Op opA = Op::NoTrans, Op opB = Op::NoTrans);
 
-// pomocnicza funkcja do generowania losowych macierzy (implementacja w Binet.cpp)
-Matrix createRandomMatrix(int n);
\ No newline at end of file
+    Matrix multiply(ConstMatrixView A, ConstMatrixView B) {
+        Matrix C(A.rows, B.cols);
+        multiplyInto(A, B, C);
+        return C;
+    }
+
+    virtual ~IMnozenie() = default;
+};
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <string>
+
+/**
+ * Sprzętowe liczniki wydajności (Linux perf_event_open) wokół mierzonego
+ * fragmentu: cykle, instrukcje, chybienia L1D (odczyty) i LLC oraz operacje
+ * zmiennoprzecinkowe podwójnej precyzji.
+ *
+ * Licznik, którego nie da się otworzyć (brak PMU w maszynie wirtualnej,
+ * perf_event_paranoid, inny system, nieznany procesor dla fp_ops), ma
+ * wartość -1 i w plikach wynikowych jest wypisywany jako "-". Przy
+ * multipleksowaniu wartości są skalowane czasem, w którym licznik działał.
+ *
+ * Liczniki dziedziczą wątki utworzone po konstrukcji obiektu, więc żeby
+ * liczyć też pracę workerów, PerfCounters trzeba utworzyć przed pulą wątków.
+ */
+struct PerfSample {
+    long long cycles = -1;
+    long long instructions = -1;
+    long long l1d_misses = -1;
+    long long llc_misses = -1;
+    long long fp_ops = -1;
+};
+
+class PerfCounters {
+public:
+    // enabled = false: nic nie jest otwierane, stop() zwraca same -1
+    explicit PerfCounters(bool enabled = true);
+    ~PerfCounters();
+
+    PerfCounters(const PerfCounters &) = delete;
+    PerfCounters &operator=(const PerfCounters &) = delete;
+
+    // czy udało się otworzyć choć jeden licznik
+    bool available() const;
+
+    void start();
+    PerfSample stop();
+
+private:
+    // Intel liczy FP_ARITH_INST_RETIRED osobno dla każdej szerokości wektora
+    // (wagi 1/2/4/8), AMD podaje od razu liczbę operacji (tylko FpScalar).
+    enum Event { Cycles, Instructions, L1DMisses, LLCMisses, FpScalar, Fp128, Fp256, Fp512, kEvents };
+
+    struct Reading {
+        unsigned long long value = 0;
+        unsigned long long enabled = 0;
+        unsigned long long running = 0;
+    };
+
+    Reading read(int event) const;
+
+    int fds_[kEvents];
+    int fpWeight_[kEvents] = {};
+    Reading base_[kEvents];
+};
+
+// Czy pomiar licznikami jest włączony zmienną środowiskową MATRIX_PERF (!= "0")
+bool perfCountersRequested();
+
+// "cycles instructions l1d_misses llc_misses fp_ops" oddzielone spacjami, "-" = brak
+std::string perfSampleString(const PerfSample &sample);
@@ -0,0 +1,213 @@
+#pragma once
+
+// Wygenerowane przez AIutils/cse.py - nie edytować ręcznie.
+// run(a, b, c): a - A wierszami (M * K), b - B wierszami (K * N),
+// c - C wierszami (M * N); c nie może nachodzić na a ani b.
+
+struct AI455Schedule {
+    static constexpr int M = 4, K = 5, N = 5, R = 76;
+    static constexpr int adds = 136, subs = 225, muls = 76;
+
+    template <class T>
+    static inline __attribute__((always_inline)) void run(const T *a, const T *b, T *c) {
+        const T sa0 = a[1] + a[3];
+        const T sa1 = a[2] - a[3];
+        const T sa2 = a[6] + a[9];
+        const T sa3 = a[11] - a[12];
+        const T sa4 = a[15] - a[16];
+        const T sa5 = a[7] - a[9];
+        const T sa6 = a[10] - a[12];
+        const T sa7 = a[15] - a[19];
+        const T sa8 = a[4] - sa1;
+        const T sa9 = a[3] + a[13];
+        const T sa10 = a[13] + sa6;
+        const T sa11 = a[17] - a[18];
+        const T sa12 = a[0] - sa7;
+        const T sa13 = a[5] + a[15];
+        const T sa14 = a[5] + sa5;
+        const T sa15 = a[7] - a[8];
+        const T sa16 = a[9] - a[14];
+        const T sa17 = a[0] - sa4;
+        const T sa18 = a[2] - sa3;
+        const T sa19 = a[2] - sa6;
+        const T sa20 = a[4] + sa2;
+        const T sa21 = a[4] + sa9;
+        const T sa22 = a[5] + sa4;
+        const T sa23 = a[5] - sa16;
+        const T sa24 = a[8] + sa8;
+        const T sa25 = a[10] + sa4;
+        const T sa26 = a[12] - a[13];
+        const T sa27 = a[13] + sa0;
+        const T sa28 = a[14] - sa2;
+        const T sa29 = a[18] + sa7;
+        const T sa30 = a[18] + sa13;
+        const T sa31 = a[19] + sa2;
+        const T sa32 = a[19] - sa5;
+        const T sa33 = sa0 - sa3;
+        const T sb0 = b[15] + b[16];
+        const T sb1 = b[0] - b[3];
+        const T sb2 = b[10] + b[12];
+        const T sb3 = b[20] + b[22];
+        const T sb4 = b[19] + sb0;
+        const T sb5 = b[1] + b[21];
+        const T sb6 = b[2] + sb3;
+        const T sb7 = b[13] + b[18];
+        const T sb8 = b[0] + b[4];
+        const T sb9 = b[4] + sb1;
+        const T sb10 = b[10] + b[11];
+        const T sb11 = b[15] + b[17];
+        const T sb12 = b[20] - b[23];
+        const T sb13 = b[11] + sb2;
+        const T sb14 = b[13] + b[23];
+        const T sb15 = b[14] + b[19];
+        const T sb16 = b[17] + sb0;
+        const T sb17 = b[18] + sb12;
+        const T sb18 = b[24] + sb3;
+        const T sb19 = sb4 - sb8;
+        const T sb20 = b[1] + sb1;
+        const T sb21 = b[2] - sb16;
+        const T sb22 = b[9] + b[24];
+        const T sb23 = b[14] + sb4;
+        const T sb24 = b[14] + sb9;
+        const T sb25 = b[21] + sb10;
+        const T sb26 = b[21] + sb13;
+        const T sb27 = sb1 + sb5;
+        const T sb28 = sb2 - sb7;
+        const T sb29 = sb2 - sb14;
+        const T sb30 = sb5 - sb19;
+        const T sb31 = sb7 - sb10;
+        const T sb32 = sb11 + sb15;
+        const T h0 = a[11] * (-b[5] - b[9] - b[10]);
+        const T h1 = (-sa28) * (-b[9] - b[20]);
+        const T h2 = (-sa25) * (b[9] - b[0]);
+        const T h3 = sa27 * (-b[9] - b[15]);
+        const T h4 = sa20 * (b[20] - b[8]);
+        const T h5 = (-sa31) * (b[7] + b[20]);
+        const T h6 = (-sa17) * (b[0] + b[8]);
+        const T h7 = (sa3 - a[17]) * (b[10] - b[7]);
+        const T h8 = (a[18] - sa0) * (b[7] + b[15]);
+        const T h9 = sa2 * b[20];
+        const T h10 = (-sa22) * (b[6] - b[0]);
+        const T h11 = sa4 * b[0];
+        const T h12 = (a[8] + sa0) * (b[6] + b[15]);
+        const T h13 = sa18 * (b[8] + b[10]);
+        const T h14 = (-sa0) * b[15];
+        const T h15 = (-sa3) * b[10];
+        const T h16 = (a[6] + sa33 - sa15 - sa22) * b[6];
+        const T h17 = a[5] * (b[0] + sb5);
+        const T h18 = (-a[7]) * sb25;
+        const T h19 = (sa14 - a[4]) * (-sb27);
+        const T h20 = sa14 * b[21];
+        const T h21 = (sa1 - a[8]) * (sb20 + sb31);
+        const T h22 = a[2] * (sb7 - b[10]);
+        const T h23 = a[4] * (-sb17);
+        const T h24 = (-a[0]) * sb1;
+        const T h25 = sa8 * b[18];
+        const T h26 = sa19 * sb24;
+        const T h27 = (-a[13]) * (-b[15] - sb15);
+        const T h28 = a[10] * (b[14] + sb8);
+        const T h29 = sa10 * b[14];
+        const T h30 = (-sa21) * (-b[24] - sb17);
+        const T h31 = sa30 * sb21;
+        const T h32 = a[17] * (-sb2);
+        const T h33 = a[18] * (sb11 - b[2]);
+        const T h34 = (-a[19]) * sb6;
+        const T h35 = (-sa32) * sb26;
+        const T h36 = (-sa29) * b[2];
+        const T h37 = (-a[7] - sa10) * sb23;
+        const T h38 = (-a[10] - sa29) * (b[24] + sb6);
+        const T h39 = (sa8 - a[18]) * (-sb28);
+        const T h40 = (-sa12) * (sb6 + sb29);
+        const T h41 = (-sa23) * (-sb30);
+        const T h42 = a[8] * sb0;
+        const T h43 = (a[7] + sa3) * (b[6] - b[10]);
+        const T h44 = (-a[17] - sa26) * (sb18 + sb32);
+        const T h45 = (-a[14]) * (-b[20] - b[24]);
+        const T h46 = (sa23 - a[10]) * (b[1] - sb19);
+        const T h47 = (a[12] - a[7]) * (b[6] + b[11] + sb23);
+        const T h48 = (sa24 - a[0] - sa14) * (-sb20);
+        const T h49 = (-a[3] - a[8]) * (b[6] + sb31 - b[16]);
+        const T h50 = a[6] * (b[5] + b[6] - b[20]);
+        const T h51 = a[16] * (b[0] + b[5] + b[7]);
+        const T h52 = (-a[1]) * (b[8] + b[15] - b[5]);
+        const T h53 = (sa11 + sa33 - a[16] - sa31) * b[7];
+        const T h54 = (a[3] - a[18]) * (b[17] + sb28 - b[7]);
+        const T h55 = (sa12 - a[4]) * (sb3 + sb29);
+        const T h56 = (-a[10] - a[15]) * (-b[4] - sb6 - sb22);
+        const T h57 = (-a[14] - sa21) * (-b[24] - sb12);
+        const T h58 = (-sa11 - sa26) * (b[19] + sb11 + sb18);
+        const T h59 = (a[9] + a[19]) * (b[7] - b[22] - sb26);
+        const T h60 = sa9 * (b[19] + sb9 - sb17 - sb22);
+        const T h61 = sa13 * (b[1] + b[6] + sb21);
+        const T h62 = (-a[12] - a[17]) * (-b[7] - b[12] - sb32);
+        const T h63 = (a[0] - sa9 - sa19) * sb9;
+        const T h64 = (a[15] - a[0]) * (b[3] + b[8] + b[23] - sb6);
+        const T h65 = (sa17 + sa18 - a[1] - sa20) * b[8];
+        const T h66 = sa16 * (b[24] + sb30 - b[9]);
+        const T h67 = (sa12 - sa8 - sa11) * (b[13] - sb2);
+        const T h68 = (-sa1 - sa15) * (sb14 - b[8] - sb25);
+        const T h69 = (a[17] - sa32) * (-sb13);
+        const T h70 = (a[14] + sa11 - sa7 - sa10) * (-sb18);
+        const T h71 = (-a[8] - sa30) * sb16;
+        const T h72 = (sa5 - sa24) * (b[8] + sb27 - b[23]);
+        const T h73 = (a[5] - sa10 - sa15) * sb4;
+        const T h74 = (a[11] + sa27 + sa28 - sa25) * (-b[9]);
+        const T h75 = (a[2] + a[12]) * (b[8] + b[13] - sb24);
+        const T sc0 = h9 - h11;
+        const T sc1 = h14 + h15;
+        const T sc2 = sc0 + sc1;
+        const T sc3 = h1 + h2;
+        const T sc4 = h3 - h14;
+        const T sc5 = h4 - h6;
+        const T sc6 = h5 + h7;
+        const T sc7 = h8 - h33;
+        const T sc8 = h9 + h17;
+        const T sc9 = h9 - h34;
+        const T sc10 = h10 - h11;
+        const T sc11 = h11 - h34;
+        const T sc12 = h12 - h16;
+        const T sc13 = h13 - h15;
+        const T sc14 = h14 + h22;
+        const T sc15 = h15 + h27;
+        const T sc16 = h17 - h20;
+        const T sc17 = h18 - h42;
+        const T sc18 = h19 - h21;
+        const T sc19 = h22 + h25;
+        const T sc20 = h23 + h24;
+        const T sc21 = h26 + h30;
+        const T sc22 = h27 - h29;
+        const T sc23 = h28 + h45;
+        const T sc24 = h31 + h35;
+        const T sc25 = h32 + h36;
+        const T sc26 = h37 - h41;
+        const T sc27 = h38 - h44;
+        const T sc28 = h39 - h40;
+        const T sc29 = h43 - sc12;
+        const T sc30 = h53 - sc6;
+        const T sc31 = h65 - sc5;
+        const T sc32 = h74 + sc3;
+        const T sc33 = sc4 + sc22;
+        const T sc34 = sc10 - sc16;
+        const T sc35 = sc13 + sc19;
+        c[0] = h13 + h52 - sc2 - sc31;
+        c[1] = h12 + h20 + h24 + h48 + h49 + sc14 + sc18 - h42;
+        c[2] = h23 + h54 + sc14 + sc28 - h36 - h55 - sc7;
+        c[3] = sc20 + sc35 - sc0 - sc31;
+        c[4] = h60 + h63 + sc20 + sc21 - sc33;
+        c[5] = h10 + h50 + sc2 - sc29;
+        c[6] = sc29 - sc1 - sc17 - sc34;
+        c[7] = h36 + sc17 + sc24 - h5 - h59 - h71 - sc9;
+        c[8] = h72 + sc8 + sc18 - h4 - h18 - h23 - h25 - h68;
+        c[9] = h45 + h66 + h73 - h1 - h29 - h42 - sc8 - sc26;
+        c[10] = sc2 + sc32 - h0 - h3;
+        c[11] = h43 + h47 - h18 - h20 - h28 - h46 - sc15 - sc26;
+        c[12] = h62 + sc25 - h7 - h45 - h70 - sc15 - sc27;
+        c[13] = h75 + sc21 + sc23 - h57 - sc35;
+        c[14] = sc23 + sc33 - sc0 - sc32;
+        c[15] = h8 + h51 + sc30 - sc2;
+        c[16] = h32 + h61 + sc34 - h33 - h69 - sc24;
+        c[17] = sc1 + sc9 - sc7 - sc25 - sc30;
+        c[18] = h24 + h25 + h64 + sc11 - h6 - h32 - h67 - sc28;
+        c[19] = h2 + h29 + h56 + h58 + sc27 - h28 - h33 - sc11;
+    }
+};
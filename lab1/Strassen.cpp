@@ -1,85 +1,260 @@
 #include "Strassen.h"
 #include "SupportFunctions.h"
+#include "Gemm.h"
+#include "ThreadPool.h"
+#include "Arena.h"
+#include "FixedKernels.h"
 
 #include <algorithm>
+#include <chrono>
 #include <stdexcept>
 #include <memory>
+#include <functional>
 #include <vector>
 
 namespace {
 
-using Matrix = ::Matrix;
+// Liść rekurencji: któryś wymiar <= leafSize albo równy 1
+bool isLeaf(int m, int k, int n, int leafSize) {
+    return std::min({m, k, n}) <= std::max(leafSize, 1);
+}
+
+// Kształt daleki od kwadratu (najdłuższy wymiar > 2x najkrótszy) dzielony
+// jest najpierw wzdłuż najdłuższego wymiaru: 0 - wiersze A, 1 - wspólny, 2 - kolumny B
+int splitDimension(int m, int k, int n) {
+    int longest = std::max({m, k, n});
+    if (longest <= 2 * std::min({m, k, n})) return -1;
+    return longest == m ? 0 : longest == n ? 2 : 1;
+}
 
-Matrix multiplyRec(const Matrix &A, const Matrix &B) {
-    int Arows = static_cast<int>(A.size());
-    int Acols = Arows ? static_cast<int>(A[0].size()) : 0;
-    int Brows = static_cast<int>(B.size());
-    int Bcols = Brows ? static_cast<int>(B[0].size()) : 0;
-    if (Arows != Acols || Acols != Brows || Brows != Bcols) {
-        throw std::runtime_error("Implemented only for square matrices");
+// Elementy areny potrzebne rekurencji dla m x k * k x n: poziom Strassena
+// to 7 iloczynów P1..P7 (m/2 x n/2) i bufory sum bieżącego zadania.
+std::size_t scratchSize(int m, int k, int n, int leafSize) {
+    if (isLeaf(m, k, n, leafSize)) return 0;
+    if (m == k && k == n && (n == 2 || n == 4)) return 0;
+    switch (splitDimension(m, k, n)) {
+        case 0: return scratchSize(m - m / 2, k, n, leafSize);
+        case 1: return scratchSize(m, k - k / 2, n, leafSize);
+        case 2: return scratchSize(m, k, n - n / 2, leafSize);
+        default: break;
     }
+    if (m % 2 == 1 || k % 2 == 1 || n % 2 == 1) return scratchSize(m & ~1, k & ~1, n & ~1, leafSize);
+    int hm = m / 2, hk = k / 2, hn = n / 2;
+    return 7 * Arena::footprint(hm, hn) + Arena::footprint(hm, hk) + Arena::footprint(hk, hn) +
+           scratchSize(hm, hk, hn, leafSize);
+}
 
-    if (Arows == 1) {
-        return A * B;
+// C = alpha * op(A) * op(B) (albo C += ... przy accumulate) zapisywane
+// w miejscu do widoku C, dla dowolnych m x k * k x n. alpha wchodzi tam, gdzie
+// wynik trafia do C: w liściach i przy składaniu P1..P7 (same iloczyny P
+// liczone są z alpha = 1). Kształt wydłużony dzielony jest na połowy
+// wzdłuż najdłuższego wymiaru (wiersze / kolumny - dwa niezależne zadania,
+// wspólny wymiar - druga połowa akumulowana w C), aż będzie bliski kwadratowi. Wtedy poziom Strassena:
+// każdy z siedmiu iloczynów P1..P7 to osobne zadanie z własnymi buforami na sumy
+// bloków A i B (sekwencyjnie żyją one tylko w trakcie jednego zadania, więc
+// szczyt pamięci to nadal 7 + 2 bloki); bloki wejścia i wyjścia to widoki, więc
+// nie ma subMatrix/combine. Nieparzyste wymiary - dynamic peeling.
+// Wszystkie bufory pochodzą z areny wątku i są zwalniane hurtowo przy wyjściu.
+// Przy parallelDepth > 0 zadania trafiają do puli wątków.
+void multiplyRec(ConstMatrixView A, ConstMatrixView B, MatrixView C, bool accumulate, const GemmForm &form,
+                 int leafSize, int parallelDepth) {
+    int Arows = opRows(A, form.opA);
+    int Acols = opCols(A, form.opA);
+    int Brows = opRows(B, form.opB);
+    int Bcols = opCols(B, form.opB);
+    if (Acols != Brows) {
+        throw std::runtime_error("Incompatible dimensions for multiplication");
     }
+    bool square = Arows == Acols && Acols == Bcols;
 
-    if (Arows % 2 == 0) {
-        int size = Arows;
-        int halfSize = size / 2;
-        memCounterEnterCall(static_cast<std::size_t>(size), static_cast<std::size_t>(size), 4);
+    if (square && Arows == 1) {
+        if (form.plain()) multiplyInto(A, B, C, accumulate);
+        else gemm(C, form, A, B, accumulate);
+        return;
+    }
+    if (isLeaf(Arows, Acols, Bcols, leafSize)) {
+        if (form.plain() && isFixedShape(Arows, Acols, Bcols)) fixedMultiplyInto(A, B, C, accumulate);
+        else gemm(C, form, A, B, accumulate);
+        return;
+    }
+    // Dwa ostatnie poziomy rekurencji jako jądra rozwinięte w czasie kompilacji
+    // (FixedKernels.h) - te same operacje, bez buforów i zadań
+    if (square && Arows == 2 && form.plain()) {
+        schemeMultiplyInto<Strassen222>(A, B, C, accumulate);
+        return;
+    }
+    if (square && Arows == 4 && form.plain()) {
+        if (leafSize < 2) schemeMultiplyInto<Nested<Strassen222, Strassen222>>(A, B, C, accumulate);
+        else schemeMultiplyInto<Nested<Strassen222, ClassicalScheme<2, 2, 2>>>(A, B, C, accumulate);
+        return;
+    }
+
+    int split = splitDimension(Arows, Acols, Bcols);
+    if (split == 0 || split == 2) {
+        // połowy C są niezależne; głębokość zrównoleglenia zostaje dla poziomów Strassena
+        int half = (split == 0 ? Arows : Bcols) / 2;
+        TaskGroup group(parallelDepth > 0 ? &threadPool() : nullptr);
+        if (split == 0) {
+            int rest = Arows - half;
+            group.run([&] { multiplyRec(opBlock(A, form.opA, 0, 0, half, Acols), B, C.block(0, 0, half, Bcols), accumulate, form, leafSize, parallelDepth); });
+            group.run([&] { multiplyRec(opBlock(A, form.opA, half, 0, rest, Acols), B, C.block(half, 0, rest, Bcols), accumulate, form, leafSize, parallelDepth); });
+        } else {
+            int rest = Bcols - half;
+            group.run([&] { multiplyRec(A, opBlock(B, form.opB, 0, 0, Brows, half), C.block(0, 0, Arows, half), accumulate, form, leafSize, parallelDepth); });
+            group.run([&] { multiplyRec(A, opBlock(B, form.opB, 0, half, Brows, rest), C.block(0, half, Arows, rest), accumulate, form, leafSize, parallelDepth); });
+        }
+        group.wait();
+        return;
+    }
+    if (split == 1) {
+        // C = A1 * B1 + A2 * B2, drugi iloczyn akumulowany wprost w C
+        int half = Acols / 2, rest = Acols - half;
+        multiplyRec(opBlock(A, form.opA, 0, 0, Arows, half), opBlock(B, form.opB, 0, 0, half, Bcols), C,
+                    accumulate, form, leafSize, parallelDepth);
+        multiplyRec(opBlock(A, form.opA, 0, half, Arows, rest), opBlock(B, form.opB, half, 0, rest, Bcols), C,
+                    true, form, leafSize, parallelDepth);
+        return;
+    }
+
+    if (Arows % 2 == 0 && Acols % 2 == 0 && Bcols % 2 == 0) {
+        int hm = Arows / 2, hk = Acols / 2, hn = Bcols / 2;
+        std::size_t h = static_cast<std::size_t>(hm), w = static_cast<std::size_t>(hn);
+        memCounterEnterCall(h, w, 7);
     
-        Matrix A11 = subMatrix(A, 0, 0, halfSize, halfSize);
-        Matrix A12 = subMatrix(A, 0, halfSize, halfSize, halfSize);
-        Matrix A21 = subMatrix(A, halfSize, 0, halfSize, halfSize);
-        Matrix A22 = subMatrix(A, halfSize, halfSize, halfSize, halfSize);
+        ConstMatrixView A11 = opBlock(A, form.opA, 0, 0, hm, hk);
+        ConstMatrixView A12 = opBlock(A, form.opA, 0, hk, hm, hk);
+        ConstMatrixView A21 = opBlock(A, form.opA, hm, 0, hm, hk);
+        ConstMatrixView A22 = opBlock(A, form.opA, hm, hk, hm, hk);
         
-        Matrix B11 = subMatrix(B, 0, 0, halfSize, halfSize);
-        Matrix B12 = subMatrix(B, 0, halfSize, halfSize, halfSize);
-        Matrix B21 = subMatrix(B, halfSize, 0, halfSize, halfSize);
-        Matrix B22 = subMatrix(B, halfSize, halfSize, halfSize, halfSize);
-        
-        Matrix P1 = multiplyRec(A11 + A22, B11 + B22);
-        Matrix P2 = multiplyRec(A21 + A22, B11);
-        Matrix P3 = multiplyRec(A11, B12 - B22);
-        Matrix P4 = multiplyRec(A22, B21 - B11);
-        Matrix P5 = multiplyRec(A11 + A12, B22);
-        Matrix P6 = multiplyRec(A21 - A11, B11 + B12);
-        Matrix P7 = multiplyRec(A12 - A22, B21 + B22);
-
-        Matrix C11 = P1 + P4 - P5 + P7;
-        Matrix C12 = P3 + P5;
-        Matrix C21 = P2 + P4;
-        Matrix C22 = P1 + P3 - P2 + P6;
-
-        Matrix M = combine(C11, C12, C21, C22);
-
-        memCounterExitCall(static_cast<std::size_t>(size), static_cast<std::size_t>(size), 4);
-        return M;
-    } else {
-        int size = Arows;
+        ConstMatrixView B11 = opBlock(B, form.opB, 0, 0, hk, hn);
+        ConstMatrixView B12 = opBlock(B, form.opB, 0, hn, hk, hn);
+        ConstMatrixView B21 = opBlock(B, form.opB, hk, 0, hk, hn);
+        ConstMatrixView B22 = opBlock(B, form.opB, hk, hn, hk, hn);
+
+        MatrixView C11 = C.block(0, 0, hm, hn);
+        MatrixView C12 = C.block(0, hn, hm, hn);
+        MatrixView C21 = C.block(hm, 0, hm, hn);
+        MatrixView C22 = C.block(hm, hn, hm, hn);
 
-        memCounterEnterCall(static_cast<std::size_t>(size), static_cast<std::size_t>(size), 4);
+        Arena &arena = threadArena();
+        Arena::Scope scope(arena);
+        MatrixView P1 = arena.allocate(hm, hn), P2 = arena.allocate(hm, hn),
+                   P3 = arena.allocate(hm, hn), P4 = arena.allocate(hm, hn),
+                   P5 = arena.allocate(hm, hn), P6 = arena.allocate(hm, hn),
+                   P7 = arena.allocate(hm, hn);
 
-        Matrix A11 = subMatrix(A, 0, 0, size - 1, size - 1);
-        Matrix A12 = subMatrix(A, 0, size - 1, size - 1, 1);
-        Matrix A21 = subMatrix(A, size - 1, 0, 1, size - 1);
-        Matrix A22 = subMatrix(A, size - 1, size - 1, 1, 1);
+        GemmForm inner{form.opA, form.opB, 1.0};
+        int d = parallelDepth > 0 ? parallelDepth - 1 : 0;
+        TaskGroup group(parallelDepth > 0 ? &threadPool() : nullptr);
+        group.run([&] {
+            memCounterEnterCall(h, w, 2);
+            Arena &local = threadArena();
+            Arena::Scope taskScope(local);
+            MatrixView SA = local.allocate(A11.rows, A11.cols), SB = local.allocate(B11.rows, B11.cols);
+            addInto(A11, A22, SA); addInto(B11, B22, SB);
+            multiplyRec(SA, SB, P1, false, inner, leafSize, d);
+            memCounterExitCall(h, w, 2);
+        });
+        group.run([&] {
+            memCounterEnterCall(h, w, 1);
+            Arena &local = threadArena();
+            Arena::Scope taskScope(local);
+            MatrixView SA = local.allocate(A11.rows, A11.cols);
+            addInto(A21, A22, SA);
+            multiplyRec(SA, B11, P2, false, inner, leafSize, d);
+            memCounterExitCall(h, w, 1);
+        });
+        group.run([&] {
+            memCounterEnterCall(h, w, 1);
+            Arena &local = threadArena();
+            Arena::Scope taskScope(local);
+            MatrixView SB = local.allocate(B11.rows, B11.cols);
+            subInto(B12, B22, SB);
+            multiplyRec(A11, SB, P3, false, inner, leafSize, d);
+            memCounterExitCall(h, w, 1);
+        });
+        group.run([&] {
+            memCounterEnterCall(h, w, 1);
+            Arena &local = threadArena();
+            Arena::Scope taskScope(local);
+            MatrixView SB = local.allocate(B11.rows, B11.cols);
+            subInto(B21, B11, SB);
+            multiplyRec(A22, SB, P4, false, inner, leafSize, d);
+            memCounterExitCall(h, w, 1);
+        });
+        group.run([&] {
+            memCounterEnterCall(h, w, 1);
+            Arena &local = threadArena();
+            Arena::Scope taskScope(local);
+            MatrixView SA = local.allocate(A11.rows, A11.cols);
+            addInto(A11, A12, SA);
+            multiplyRec(SA, B22, P5, false, inner, leafSize, d);
+            memCounterExitCall(h, w, 1);
+        });
+        group.run([&] {
+            memCounterEnterCall(h, w, 2);
+            Arena &local = threadArena();
+            Arena::Scope taskScope(local);
+            MatrixView SA = local.allocate(A11.rows, A11.cols), SB = local.allocate(B11.rows, B11.cols);
+            subInto(A21, A11, SA); addInto(B11, B12, SB);
+            multiplyRec(SA, SB, P6, false, inner, leafSize, d);
+            memCounterExitCall(h, w, 2);
+        });
+        group.run([&] {
+            memCounterEnterCall(h, w, 2);
+            Arena &local = threadArena();
+            Arena::Scope taskScope(local);
+            MatrixView SA = local.allocate(A11.rows, A11.cols), SB = local.allocate(B11.rows, B11.cols);
+            subInto(A12, A22, SA); addInto(B21, B22, SB);
+            multiplyRec(SA, SB, P7, false, inner, leafSize, d);
+            memCounterExitCall(h, w, 2);
+        });
+        group.wait();
 
-        Matrix B11 = subMatrix(B, 0, 0, size - 1, size - 1);
-        Matrix B12 = subMatrix(B, 0, size - 1, size - 1, 1);
-        Matrix B21 = subMatrix(B, size - 1, 0, 1, size - 1);
-        Matrix B22 = subMatrix(B, size - 1, size - 1, 1, 1);
+        if (accumulate || form.alpha != 1.0) {
+            // C11 += a (P1 + P4 - P5 + P7), C12 += a (P3 + P5), C21 += a (P2 + P4),
+            // C22 += a (P1 + P3 - P2 + P6) - przy a = +-1 tyle samo operacji co C = ...
+            double a = form.alpha;
+            if (!accumulate) setZero(C);
+            axpyAssign(C11, a, P1); axpyAssign(C11, a, P4); axpyAssign(C11, -a, P5); axpyAssign(C11, a, P7);
+            axpyAssign(C12, a, P3); axpyAssign(C12, a, P5);
+            axpyAssign(C21, a, P2); axpyAssign(C21, a, P4);
+            axpyAssign(C22, a, P1); axpyAssign(C22, a, P3); axpyAssign(C22, -a, P2); axpyAssign(C22, a, P6);
+        } else {
+            // C11 = P1 + P4 - P5 + P7
+            addInto(P1, P4, C11); subAssign(C11, P5); addAssign(C11, P7);
+            // C12 = P3 + P5
+            addInto(P3, P5, C12);
+            // C21 = P2 + P4
+            addInto(P2, P4, C21);
+            // C22 = P1 + P3 - P2 + P6
+            addInto(P1, P3, C22); subAssign(C22, P2); addAssign(C22, P6);
+        }
 
-        Matrix C11 = multiplyRec(A11, B11) + A12 * B21;
-        Matrix C12 = A11 * B12 + A12 * B22;
-        Matrix C21 = A21 * B11 + A22 * B21;
-        Matrix C22 = A21 * B12 + A22 * B22;
+        memCounterExitCall(h, w, 7);
+    } else {
+        // dynamic peeling na widokach: Strassen tylko dla parzystego rdzenia
+        // mc x kc * kc x nc, ostatnia kolumna A / wiersz B, ostatnia kolumna
+        // i ostatni wiersz C liczone blokowym gemm (bez alokacji - gemm
+        // pakuje do buforów wielokrotnego użytku)
+        std::size_t h = static_cast<std::size_t>(Arows), w = static_cast<std::size_t>(Bcols);
+        memCounterEnterCall(h, w, 0);
 
-        Matrix M = combine(C11, C12, C21, C22);
+        int mc = Arows & ~1, kc = Acols & ~1, nc = Bcols & ~1;
+        MatrixView C11 = C.block(0, 0, mc, nc);
 
-        memCounterExitCall(static_cast<std::size_t>(size), static_cast<std::size_t>(size), 4);
+        multiplyRec(opBlock(A, form.opA, 0, 0, mc, kc), opBlock(B, form.opB, 0, 0, kc, nc), C11, accumulate, form,
+                    leafSize, parallelDepth);
+        // C11 += a12 * b21
+        if (kc < Acols) gemm(C11, form, opBlock(A, form.opA, 0, kc, mc, 1), opBlock(B, form.opB, kc, 0, 1, nc), true);
+        // ostatnia kolumna C
+        if (nc < Bcols)
+            gemm(C.block(0, nc, mc, 1), form, opBlock(A, form.opA, 0, 0, mc, Acols), opBlock(B, form.opB, 0, nc, Brows, 1),
+                 accumulate);
+        // ostatni wiersz C
+        if (mc < Arows) gemm(C.block(mc, 0, 1, Bcols), form, opBlock(A, form.opA, mc, 0, 1, Acols), B, accumulate);
 
-        return M;
+        memCounterExitCall(h, w, 0);
     }
 }
 
@@ -87,12 +262,69 @@ Matrix multiplyRec(const Matrix &A, const Matrix &B) {
 
 class StrassenImpl : public IMnozenie {
 public:
-    Matrix multiply(const Matrix &A, const Matrix &B) override {
-        return multiplyRec(A, B);
+    StrassenImpl(int leafSize, int parallelDepth) : leafSize(leafSize), parallelDepth(parallelDepth) {}
+
+    void multiplyInto(ConstMatrixView A, ConstMatrixView B, MatrixView C) override {
+        Arena &arena = threadArena();
+        Arena::Scope scope(arena);
+        arena.reserve(scratchSize(A.rows, A.cols, B.cols, leafSize));
+        multiplyRec(A, B, C, false, GemmForm{}, leafSize, parallelDepth);
+    }
+
+    // beta skalowane raz z góry, dalej poziomy akumulują wprost w C
+    void multiplyAdd(MatrixView C, double alpha, ConstMatrixView A, ConstMatrixView B, double beta,
+                     Op opA, Op opB) override {
+        if (alpha == 0.0) {
+            scaleAssign(C, beta);
+            return;
+        }
+        if (beta != 0.0) scaleAssign(C, beta);
+        Arena &arena = threadArena();
+        Arena::Scope scope(arena);
+        arena.reserve(scratchSize(opRows(A, opA), opCols(A, opA), opCols(B, opB), leafSize));
+        multiplyRec(A, B, C, beta != 0.0, GemmForm{opA, opB, alpha}, leafSize, parallelDepth);
     }
+
+private:
+    int leafSize;
+    int parallelDepth;
 };
 
-std::unique_ptr<IMnozenie> createStrassen() {
-    return std::make_unique<StrassenImpl>();
+std::unique_ptr<IMnozenie> createStrassen(int leafSize, int parallelDepth) {
+    return std::make_unique<StrassenImpl>(leafSize, parallelDepth);
 }
 
+namespace {
+
+double bestTime(int repeats, const std::function<void()> &run) {
+    double best = 0.0;
+    for (int r = 0; r < repeats; ++r) {
+        auto t0 = std::chrono::steady_clock::now();
+        run();
+        auto t1 = std::chrono::steady_clock::now();
+        double t = std::chrono::duration<double>(t1 - t0).count();
+        if (r == 0 || t < best) best = t;
+    }
+    return best;
+}
+
+} // namespace
+
+int tuneStrassenLeafSize(int maxSize) {
+    const int candidates[] = {64, 96, 128, 192, 256, 384, 512, 768, 1024, 1536, 2048, 3072, 4096};
+
+    int leafSize = 32;
+    for (int n : candidates) {
+        if (n > maxSize) break;
+        Matrix A = createRandomMatrix(n);
+        Matrix B = createRandomMatrix(n);
+        Matrix C(n, n);
+
+        // jeden poziom Strassena (połówki liczone gemm) kontra samo gemm
+        double classical = bestTime(3, [&] { gemm(A, B, C); });
+        double strassen = bestTime(3, [&] { multiplyRec(A, B, C, false, GemmForm{}, n / 2, 0); });
+        if (strassen < classical) break;
+        leafSize = n;
+    }
+    return leafSize;
+}
@@ -1,64 +1,220 @@
 #include "SupportFunctions.h"
+#include "Simd.h"
 #include <random>
 #include <iomanip>
 #include <vector>
 #include <atomic>
+#include <mutex>
+#include <algorithm>
+#include <limits>
+#include <cmath>
+
+#ifndef MATRIX_NO_INSTRUMENTATION
+
+// Liczniki jednego wątku. Pisze do nich tylko wątek-właściciel (load + store
+// bez blokady, czyli zwykłe mov), atomowość jest potrzebna jedynie po to, żeby
+// odczyt z innego wątku w opCounterGet / memCounterGet był poprawny.
+// Reset nigdy ich nie nadpisuje (zapis obcego wątku mógłby zginąć w load +
+// store właściciela): operacje odejmowane są od stanu z chwili resetu (base,
+// chronione blokadą rejestru), a szczyty pamięci liczy od nowa sam właściciel,
+// gdy zobaczy nową epokę resetu (mem_epoch).
+struct ThreadCounters {
+    std::atomic<std::uint64_t> adds{0};
+    std::atomic<std::uint64_t> subs{0};
+    std::atomic<std::uint64_t> muls{0};
+    std::atomic<std::uint64_t> divs{0};
+    std::atomic<std::uint64_t> mem_current{0};
+    std::atomic<std::uint64_t> mem_peak{0};
+    std::atomic<std::uint64_t> active_calls{0};
+    std::atomic<std::uint64_t> peak_calls{0};
+    std::atomic<std::uint64_t> arena_current{0};
+    std::atomic<std::uint64_t> arena_peak{0};
+    std::atomic<std::uint64_t> mem_epoch{0};
+    OpCounts base;
+};
+
+// Liczniki wszystkich żyjących wątków oraz operacje i szczyty pamięci
+// wątków, które już się zakończyły (np. po threadPoolSetSize).
+struct CounterRegistry {
+    std::mutex mutex;
+    std::vector<ThreadCounters *> live;
+    OpCounts retired;
+    MemStats retiredMem;
+};
+
+static CounterRegistry &registry() {
+    static CounterRegistry *r = new CounterRegistry; // celowo bez destruktora - wątki mogą kończyć się po main
+    return *r;
+}
+
+// Zwiększana przez memCounterReset; wątki czytają ją bez RMW
+static std::atomic<std::uint64_t> g_mem_epoch{0};
+
+// Stan pamięci wątku od ostatniego resetu - wątek, który jeszcze nie zobaczył
+// nowej epoki, ma szczyty równe bieżącemu stanowi
+static MemStats memStats(const ThreadCounters &t) {
+    MemStats s{t.mem_current, t.mem_peak, t.active_calls, t.peak_calls, t.arena_current, t.arena_peak};
+    if (t.mem_epoch.load(std::memory_order_acquire) != g_mem_epoch.load(std::memory_order_relaxed)) {
+        s.peak_bytes = s.current_bytes;
+        s.peak_calls = s.active_calls;
+        s.arena_peak_bytes = s.arena_current_bytes;
+    }
+    return s;
+}
+
+static void addPeaks(MemStats &sum, const MemStats &s) {
+    sum.peak_bytes += s.peak_bytes;
+    sum.peak_calls += s.peak_calls;
+    sum.arena_peak_bytes += s.arena_peak_bytes;
+}
+
+// Rejestruje liczniki wątku przy pierwszym użyciu i wyrejestrowuje je
+// (przenosząc operacje i szczyty do retired) przy zakończeniu wątku.
+struct ThreadCountersHandle {
+    ThreadCounters counters;
+
+    ThreadCountersHandle() {
+        CounterRegistry &r = registry();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        counters.mem_epoch = g_mem_epoch.load();
+        r.live.push_back(&counters);
+    }
 
-// we use plain uint64_t (single-threaded). If multithreaded, change to atomic.
-static std::uint64_t g_adds = 0;
-static std::uint64_t g_subs = 0;
-static std::uint64_t g_muls = 0;
-static std::uint64_t g_divs = 0;
+    ~ThreadCountersHandle() {
+        CounterRegistry &r = registry();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        r.retired.adds += counters.adds - counters.base.adds;
+        r.retired.subs += counters.subs - counters.base.subs;
+        r.retired.muls += counters.muls - counters.base.muls;
+        r.retired.divs += counters.divs - counters.base.divs;
+        addPeaks(r.retiredMem, memStats(counters));
+        r.live.erase(std::find(r.live.begin(), r.live.end(), &counters));
+    }
+};
+
+static ThreadCounters &threadCounters() {
+    thread_local ThreadCountersHandle handle;
+    return handle.counters;
+}
+
+static void localAdd(std::atomic<std::uint64_t> &c, std::uint64_t value) {
+    c.store(c.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+}
+
+static void localSub(std::atomic<std::uint64_t> &c, std::uint64_t value) {
+    std::uint64_t prev = c.load(std::memory_order_relaxed);
+    c.store(prev >= value ? prev - value : 0, std::memory_order_relaxed);
+}
+
+static void localMax(std::atomic<std::uint64_t> &c, std::uint64_t value) {
+    if (value > c.load(std::memory_order_relaxed)) c.store(value, std::memory_order_relaxed);
+}
 
 void opCounterReset() {
-    g_adds = g_subs = g_muls = g_divs = 0;
+    CounterRegistry &r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    for (ThreadCounters *t : r.live) {
+        t->base = OpCounts{t->adds, t->subs, t->muls, t->divs};
+    }
+    r.retired = OpCounts{};
 }
 
 OpCounts opCounterGet() {
-    return OpCounts{g_adds, g_subs, g_muls, g_divs};
+    CounterRegistry &r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    OpCounts sum = r.retired;
+    for (const ThreadCounters *t : r.live) {
+        sum.adds += t->adds - t->base.adds;
+        sum.subs += t->subs - t->base.subs;
+        sum.muls += t->muls - t->base.muls;
+        sum.divs += t->divs - t->base.divs;
+    }
+    return sum;
 }
 
 void opCounterAdd(const OpCounts &c) {
-    g_adds += c.adds;
-    g_subs += c.subs;
-    g_muls += c.muls;
-    g_divs += c.divs;
+    ThreadCounters &t = threadCounters();
+    localAdd(t.adds, c.adds);
+    localAdd(t.subs, c.subs);
+    localAdd(t.muls, c.muls);
+    localAdd(t.divs, c.divs);
 }
 
-static std::uint64_t g_mem_current = 0;
-static std::uint64_t g_mem_peak = 0;
-static std::uint64_t g_active_calls = 0;
-static std::uint64_t g_peak_calls = 0;
-
 void memCounterReset() {
-    g_mem_current = 0;
-    g_mem_peak = 0;
-    g_active_calls = 0;
-    g_peak_calls = 0;
+    allocCounterReset();
+
+    CounterRegistry &r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    ++g_mem_epoch;
+    r.retiredMem = MemStats{};
+}
+
+// Liczniki pamięci wątku; po resecie właściciel zaczyna szczyty od bieżącego stanu
+static ThreadCounters &memCounters() {
+    ThreadCounters &t = threadCounters();
+    std::uint64_t epoch = g_mem_epoch.load(std::memory_order_relaxed);
+    if (t.mem_epoch.load(std::memory_order_relaxed) != epoch) {
+        t.mem_peak.store(t.mem_current.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        t.peak_calls.store(t.active_calls.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        t.arena_peak.store(t.arena_current.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        t.mem_epoch.store(epoch, std::memory_order_release);
+    }
+    return t;
 }
 
 void memCounterEnterCall(std::size_t p, std::size_t r, int n) {
     std::uint64_t bytes = static_cast<std::uint64_t>(p) * static_cast<std::uint64_t>(r) * sizeof(double) * n;
-    g_mem_current += bytes;
-    if (g_mem_current > g_mem_peak) g_mem_peak = g_mem_current;
-    ++g_active_calls;
-    if (g_active_calls > g_peak_calls) g_peak_calls = g_active_calls;
+    ThreadCounters &t = memCounters();
+    localAdd(t.mem_current, bytes);
+    localMax(t.mem_peak, t.mem_current.load(std::memory_order_relaxed));
+    localAdd(t.active_calls, 1);
+    localMax(t.peak_calls, t.active_calls.load(std::memory_order_relaxed));
 }
 
 void memCounterExitCall(std::size_t p, std::size_t r, int n) {
     std::uint64_t bytes = static_cast<std::uint64_t>(p) * static_cast<std::uint64_t>(r) * sizeof(double) * n;
-    // avoid underflow
-    if (g_mem_current >= bytes) g_mem_current -= bytes;
-    else g_mem_current = 0;
-    if (g_active_calls > 0) --g_active_calls;
+    ThreadCounters &t = memCounters();
+    localSub(t.mem_current, bytes);
+    localSub(t.active_calls, 1);
+}
+
+void memCounterArenaAlloc(std::size_t bytes) {
+    ThreadCounters &t = memCounters();
+    localAdd(t.arena_current, bytes);
+    localMax(t.arena_peak, t.arena_current.load(std::memory_order_relaxed));
+}
+
+void memCounterArenaRelease(std::size_t bytes) {
+    ThreadCounters &t = memCounters();
+    localSub(t.arena_current, bytes);
 }
 
 MemStats memCounterGet() {
-    return MemStats{g_mem_current, g_mem_peak, g_active_calls, g_peak_calls};
+    CounterRegistry &r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    MemStats sum = r.retiredMem;
+    for (const ThreadCounters *t : r.live) {
+        MemStats s = memStats(*t);
+        sum.current_bytes += s.current_bytes;
+        sum.active_calls += s.active_calls;
+        sum.arena_current_bytes += s.arena_current_bytes;
+        addPeaks(sum, s);
+    }
+    return sum;
+}
+
+std::vector<MemStats> memCounterGetPerThread() {
+    CounterRegistry &r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    std::vector<MemStats> stats;
+    for (const ThreadCounters *t : r.live) stats.push_back(memStats(*t));
+    return stats;
 }
 
+#endif // MATRIX_NO_INSTRUMENTATION
+
 Matrix createRandomMatrix(int m, int n) {
-    Matrix M(m, std::vector<double>(n));
+    Matrix M(m, n);
     std::mt19937_64 rng(std::random_device{}());
     // open interval (1e-8, 1.0) approximated by avoiding exact endpoints
     std::uniform_real_distribution<double> dist(1e-8 + 1e-16, 1.0 - 1e-16);
@@ -75,15 +231,15 @@ Matrix createRandomMatrix(int n) {
 
 
 void printSmall(const Matrix& M) {
-    for (size_t i = 0; i < M.size(); ++i) {
-        for (size_t j = 0; j < M[i].size(); ++j)
+    for (int i = 0; i < rows(M); ++i) {
+        for (int j = 0; j < cols(M); ++j)
             std::cout << std::setprecision(6) << std::setw(12) << M[i][j];
         std::cout << '\n';
     }
 }
 
 Matrix zeroMatrix(int rows, int cols) {
-    return Matrix(rows, std::vector<double>(cols, 0.0));
+    return Matrix(rows, cols);
 }
 
 Matrix zeroMatrix(int n) {
@@ -93,20 +249,21 @@ Matrix zeroMatrix(int n) {
 // A[row:row+rows-1][col:col+cols-1]
 Matrix subMatrix(const Matrix &A, int row, int col, int rows, int cols) {
     Matrix R = zeroMatrix(rows, cols);
-    for (int i = 0; i < rows; ++i)
-        for (int j = 0; j < cols; ++j)
-            R[i][j] = A[row + i][col + j];
+    for (int i = 0; i < rows; ++i) {
+        const double *src = A[row + i] + col;
+        std::copy(src, src + cols, R[i]);
+    }
     return R;
 }
 
 Matrix combine(const Matrix &A11, const Matrix &A12,
                const Matrix &A21, const Matrix &A22) {
-    int A11rows = static_cast<int>(A11.size());
-    int A12rows = static_cast<int>(A12.size());
-    int A11cols = A11rows ? static_cast<int>(A11[0].size()) : 0;
-    int A12cols = A12.size() ? static_cast<int>(A12[0].size()) : 0;
-    int A21rows = A21.size();
-    int A22rows = A22.size();
+    int A11rows = rows(A11);
+    int A12rows = rows(A12);
+    int A11cols = cols(A11);
+    int A12cols = cols(A12);
+    int A21rows = rows(A21);
+    int A22rows = rows(A22);
     Matrix A = zeroMatrix(A11rows + A21rows, A11cols + A12cols);
     for (int i = 0; i < A11rows; i++)
         for (int j = 0; j < A11cols; j++)
@@ -128,76 +285,160 @@ Matrix combine(const Matrix &A11, const Matrix &A12,
 }
 
 Matrix operator+(const Matrix &A, const Matrix &B) {
-    int Arows = static_cast<int>(A.size());
-    int Acols = static_cast<int>(A[0].size());
-    int Brows = static_cast<int>(B.size());
-    int Bcols = static_cast<int>(B[0].size());
+    int Arows = rows(A);
+    int Acols = cols(A);
+    int Brows = rows(B);
+    int Bcols = cols(B);
     Matrix R = zeroMatrix(std::max(Arows, Brows), std::max(Acols, Bcols));
     for (int i = 0; i < Arows; ++i)
         for (int j = 0; j < Acols; ++j)
             R[i][j] = A[i][j];
 
-    for (int i = 0; i < Brows; ++i) {
-        for (int j = 0; j < Bcols; ++j) {
-            R[i][j] += B[i][j];
-            ++g_adds;
-        }
-    }
+    for (int i = 0; i < Brows; ++i)
+        simdAdd(Bcols, R[i], B[i], R[i]);
+    opCounterAdd({static_cast<std::uint64_t>(Brows) * Bcols, 0, 0, 0});
 
     return R;
 }
 
 Matrix operator-(const Matrix &A, const Matrix &B) {
-    int Arows = static_cast<int>(A.size());
-    int Acols = static_cast<int>(A[0].size());
-    int Brows = static_cast<int>(B.size());
-    int Bcols = static_cast<int>(B[0].size());
-    Matrix R = zeroMatrix(std::max(Arows, Brows), std::max(Brows, Bcols));
+    int Arows = rows(A);
+    int Acols = cols(A);
+    int Brows = rows(B);
+    int Bcols = cols(B);
+    Matrix R = zeroMatrix(std::max(Arows, Brows), std::max(Acols, Bcols));
     for (int i = 0; i < Arows; ++i)
         for (int j = 0; j < Acols; ++j)
             R[i][j] = A[i][j];
 
-    for (int i = 0; i < Brows; ++i) {
-        for (int j = 0; j < Bcols; ++j) {
-            R[i][j] -= B[i][j];
-            ++g_subs;
-        }
-    }
+    for (int i = 0; i < Brows; ++i)
+        simdSub(Bcols, R[i], B[i], R[i]);
+    opCounterAdd({0, static_cast<std::uint64_t>(Brows) * Bcols, 0, 0});
 
     return R;
 }
 
 Matrix operator*(const Matrix &A, const Matrix &B) {
-    int p = static_cast<int>(A.size());
-    int q = p ? static_cast<int>(A[0].size()) : 0;
-    int r = B.size() ? static_cast<int>(B[0].size()) : 0;
+    int p = rows(A);
+    int q = cols(A);
+    int r = cols(B);
 
     memCounterEnterCall(static_cast<std::size_t>(p), static_cast<std::size_t>(r), 1);
 
     Matrix C = zeroMatrix(p, r);
     for (int i = 0; i < p; ++i) {
-        for (int k = 0; k < q; ++k) {
-            double aik = A[i][k];
-            for (int j = 0; j < r; ++j) {
-                double prod = aik * B[k][j];
-                ++g_muls;
-                C[i][j] += prod;
-                ++g_adds;
-            }
-        }
+        double *Ci = C[i];
+        for (int k = 0; k < q; ++k)
+            simdAxpy(r, A[i][k], B[k], Ci);
     }
-    g_adds -= p * r;
+    std::uint64_t pr = static_cast<std::uint64_t>(p) * r;
+    opCounterAdd({pr * q - pr, 0, pr * q, 0});
 
     memCounterExitCall(static_cast<std::size_t>(p), static_cast<std::size_t>(r), 1);
     return C;
 }
 
+void setZero(MatrixView C) {
+    for (int i = 0; i < C.rows; ++i)
+        std::fill(C[i], C[i] + C.cols, 0.0);
+}
+
+void copyInto(ConstMatrixView A, MatrixView C) {
+    for (int i = 0; i < A.rows; ++i)
+        std::copy(A[i], A[i] + A.cols, C[i]);
+}
+
+void addInto(ConstMatrixView A, ConstMatrixView B, MatrixView C) {
+    for (int i = 0; i < C.rows; ++i) {
+        const double *Ai = A[i];
+        const double *Bi = B[i];
+        simdAdd(C.cols, Ai, Bi, C[i]);
+    }
+    opCounterAdd({static_cast<std::uint64_t>(C.rows) * C.cols, 0, 0, 0});
+}
+
+void subInto(ConstMatrixView A, ConstMatrixView B, MatrixView C) {
+    for (int i = 0; i < C.rows; ++i) {
+        const double *Ai = A[i];
+        const double *Bi = B[i];
+        simdSub(C.cols, Ai, Bi, C[i]);
+    }
+    opCounterAdd({0, static_cast<std::uint64_t>(C.rows) * C.cols, 0, 0});
+}
+
+void addAssign(MatrixView C, ConstMatrixView A) {
+    for (int i = 0; i < C.rows; ++i)
+        simdAdd(C.cols, C[i], A[i], C[i]);
+    opCounterAdd({static_cast<std::uint64_t>(C.rows) * C.cols, 0, 0, 0});
+}
+
+void subAssign(MatrixView C, ConstMatrixView A) {
+    for (int i = 0; i < C.rows; ++i)
+        simdSub(C.cols, C[i], A[i], C[i]);
+    opCounterAdd({0, static_cast<std::uint64_t>(C.rows) * C.cols, 0, 0});
+}
+
+void scaleAssign(MatrixView C, double beta) {
+    if (beta == 1.0) return;
+    if (beta == 0.0) {
+        setZero(C);
+        return;
+    }
+    for (int i = 0; i < C.rows; ++i) {
+        double *Ci = C[i];
+        for (int j = 0; j < C.cols; ++j)
+            Ci[j] *= beta;
+    }
+    // zmiana znaku liczona jak w negateInto - jako odejmowania
+    std::uint64_t n = static_cast<std::uint64_t>(C.rows) * C.cols;
+    opCounterAdd(beta == -1.0 ? OpCounts{0, n, 0, 0} : OpCounts{0, 0, n, 0});
+}
+
+void axpyAssign(MatrixView C, double alpha, ConstMatrixView A) {
+    if (alpha == 1.0) {
+        addAssign(C, A);
+        return;
+    }
+    if (alpha == -1.0) {
+        subAssign(C, A);
+        return;
+    }
+    for (int i = 0; i < C.rows; ++i)
+        simdAxpy(C.cols, alpha, A[i], C[i]);
+    std::uint64_t n = static_cast<std::uint64_t>(C.rows) * C.cols;
+    opCounterAdd({n, 0, n, 0});
+}
+
+void transposeInto(ConstMatrixView A, MatrixView C) {
+    for (int i = 0; i < A.rows; ++i) {
+        const double *Ai = A[i];
+        for (int j = 0; j < A.cols; ++j)
+            C[j][i] = Ai[j];
+    }
+}
+
+void multiplyInto(ConstMatrixView A, ConstMatrixView B, MatrixView C, bool accumulate) {
+    int p = A.rows;
+    int q = A.cols;
+    int r = B.cols;
+
+    if (!accumulate) setZero(C);
+    for (int i = 0; i < p; ++i) {
+        double *Ci = C[i];
+        for (int k = 0; k < q; ++k)
+            simdAxpy(r, A[i][k], B[k], Ci);
+    }
+    std::uint64_t pr = static_cast<std::uint64_t>(p) * r;
+    // przy C = A * B pierwszy składnik każdej sumy nie jest dodawaniem
+    opCounterAdd({accumulate ? pr * q : pr * q - (q ? pr : 0), 0, pr * q, 0});
+}
+
 std::pair<bool,double> compareMatrices(const Matrix& X, const Matrix& Y, double tol) {
-    if (X.size() != Y.size()) return {false, std::numeric_limits<double>::infinity()};
-    int m = static_cast<int>(X.size());
+    if (rows(X) != rows(Y)) return {false, std::numeric_limits<double>::infinity()};
+    int m = rows(X);
     if (m == 0) return {true, 0.0};
-    if (X[0].size() != Y[0].size()) return {false, std::numeric_limits<double>::infinity()};
-    int n = static_cast<int>(X[0].size());
+    if (cols(X) != cols(Y)) return {false, std::numeric_limits<double>::infinity()};
+    int n = cols(X);
     double maxDiff = 0.0;
     for (int i = 0; i < m; ++i) {
         for (int j = 0; j < n; ++j) {
@@ -0,0 +1,207 @@
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+namespace {
+
+// indeks kolejki bieżącego wątku w jego puli (-1 poza pulą)
+thread_local const ThreadPool *t_pool = nullptr;
+thread_local int t_index = -1;
+
+void pinToCpu(int cpu) {
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    sched_setaffinity(0, sizeof(set), &set);
+#else
+    (void)cpu;
+#endif
+}
+
+} // namespace
+
+ThreadPool::ThreadPool(int threads, int firstCpu) : firstCpu_(firstCpu) {
+    int workers = std::max(1, threads) - 1;
+    for (int i = 0; i <= workers; ++i) queues_.push_back(std::make_unique<Queue>());
+    for (int i = 0; i < workers; ++i) {
+        workers_.emplace_back([this, i] {
+            if (firstCpu_ >= 0) pinToCpu(firstCpu_ + 1 + i);
+            workerLoop(i);
+        });
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex_);
+        stop_ = true;
+    }
+    wake_.notify_all();
+    for (auto &t : workers_) t.join();
+}
+
+void ThreadPool::submit(std::function<void()> task) {
+    int index = t_pool == this ? t_index : static_cast<int>(workers_.size());
+    {
+        std::lock_guard<std::mutex> lock(queues_[index]->mutex);
+        queues_[index]->tasks.push_back(std::move(task));
+    }
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex_);
+        ++queued_;
+    }
+    wake_.notify_one();
+}
+
+bool ThreadPool::popOrSteal(int self, std::function<void()> &task) {
+    if (self >= 0) {
+        Queue &own = *queues_[self];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.tasks.empty()) {
+            task = std::move(own.tasks.back());
+            own.tasks.pop_back();
+            return true;
+        }
+    }
+
+    int n = static_cast<int>(queues_.size());
+    int start = self >= 0 ? self + 1 : 0;
+    for (int k = 0; k < n; ++k) {
+        int victim = (start + k) % n;
+        if (victim == self) continue;
+        Queue &q = *queues_[victim];
+        std::lock_guard<std::mutex> lock(q.mutex);
+        if (!q.tasks.empty()) {
+            task = std::move(q.tasks.front());
+            q.tasks.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
+
+bool ThreadPool::runOne() {
+    if (queued_.load(std::memory_order_relaxed) == 0) return false;
+    std::function<void()> task;
+    if (!popOrSteal(t_pool == this ? t_index : -1, task)) return false;
+    --queued_;
+    task();
+    return true;
+}
+
+void ThreadPool::workerLoop(int index) {
+    t_pool = this;
+    t_index = index;
+    while (true) {
+        if (runOne()) continue;
+        std::unique_lock<std::mutex> lock(sleepMutex_);
+        wake_.wait(lock, [this] { return stop_ || queued_ > 0; });
+        if (stop_) return;
+    }
+}
+
+void ThreadPool::sleepUntil(const std::function<bool()> &done) {
+    std::unique_lock<std::mutex> lock(sleepMutex_);
+    wake_.wait(lock, [&] { return stop_ || queued_ > 0 || done(); });
+}
+
+void ThreadPool::notifyWaiters() {
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex_);
+    }
+    wake_.notify_all();
+}
+
+TaskGroup::~TaskGroup() {
+    // zadania trzymają referencje do zmiennych wołającego - nie można ich porzucić
+    join();
+}
+
+void TaskGroup::submit(std::function<void()> task) {
+    ++pending_;
+    ThreadPool *pool = pool_;
+    pool_->submit([this, pool, task = std::move(task)] {
+        try {
+            task();
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(errorMutex_);
+            if (!error_) error_ = std::current_exception();
+        }
+        // po ostatnim --pending_ grupa może już nie istnieć - dalej tylko pula
+        if (--pending_ == 0) pool->notifyWaiters();
+    });
+}
+
+void TaskGroup::join() {
+    int idle = 0;
+    while (pending_ > 0) {
+        if (pool_->runOne()) {
+            idle = 0;
+        } else if (++idle < kJoinSpins) {
+            std::this_thread::yield();
+        } else {
+            // nic do ukradzenia - sen do nowego zadania w puli albo końca grupy
+            pool_->sleepUntil([this] { return pending_ == 0; });
+            idle = 0;
+        }
+    }
+}
+
+void TaskGroup::wait() {
+    join();
+    if (error_) {
+        std::exception_ptr e = error_;
+        error_ = nullptr;
+        std::rethrow_exception(e);
+    }
+}
+
+namespace {
+
+int defaultThreads() {
+    if (const char *env = std::getenv("MATRIX_THREADS")) {
+        int n = std::atoi(env);
+        if (n > 0) return n;
+    }
+    return std::max(1u, std::thread::hardware_concurrency());
+}
+
+std::unique_ptr<ThreadPool> &poolInstance() {
+    static std::unique_ptr<ThreadPool> pool;
+    return pool;
+}
+
+} // namespace
+
+ThreadPool &threadPool() {
+    auto &pool = poolInstance();
+    if (!pool) pool = std::make_unique<ThreadPool>(defaultThreads());
+    return *pool;
+}
+
+void threadPoolSetSize(int threads, int firstCpu) {
+    auto &pool = poolInstance();
+    if (pool && pool->size() == threads && pool->firstCpu() == firstCpu) return;
+    pool.reset();
+    pool = std::make_unique<ThreadPool>(threads, firstCpu);
+}
+
+int threadPoolSize() {
+    return threadPool().size();
+}
+
+int parallelDepthFor(int branching, int threads) {
+    int depth = 0;
+    long tasks = 1;
+    while (threads > 1 && tasks < 4L * threads) {
+        tasks *= branching;
+        ++depth;
+    }
+    return depth;
+}
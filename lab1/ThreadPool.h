@@ -0,0 +1,114 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+/**
+ * Pula wątków z kradzieżą zadań (work stealing).
+ *
+ * Każdy wątek roboczy ma własną kolejkę: nowe zadania odkłada na jej koniec
+ * i stamtąd je zdejmuje (LIFO - dobra lokalność przy rekurencji), a wątki
+ * bez pracy kradną z początku cudzych kolejek (najstarsze, czyli największe
+ * podproblemy). Wątki spoza puli wrzucają zadania do wspólnej kolejki.
+ *
+ * Pula rozmiaru n ma n - 1 wątków roboczych - n-tym jest wątek czekający
+ * w TaskGroup::wait, który w tym czasie sam wykonuje zadania, a gdy nie ma
+ * czego wykonać, po krótkim kręceniu się zasypia (nie zajmuje rdzenia). Przy
+ * firstCpu >= 0 wątek roboczy i przypinany jest do rdzenia firstCpu + 1 + i
+ * (rdzeń firstCpu zostaje dla wątku wołającego).
+ */
+class ThreadPool {
+public:
+    explicit ThreadPool(int threads, int firstCpu = -1);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    int size() const { return static_cast<int>(workers_.size()) + 1; }
+    int firstCpu() const { return firstCpu_; }
+
+    void submit(std::function<void()> task);
+
+    // Wykonuje jedno zadanie (własne albo ukradzione); false gdy nie było żadnego
+    bool runOne();
+
+    // Sen do pojawienia się zadania w puli albo do done() - sprawdzanego pod
+    // blokadą, więc kto zmienia wynik done(), woła potem notifyWaiters()
+    void sleepUntil(const std::function<bool()> &done);
+    void notifyWaiters();
+
+private:
+    struct Queue {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    void workerLoop(int index);
+    bool popOrSteal(int self, std::function<void()> &task);
+
+    std::vector<std::unique_ptr<Queue>> queues_; // [0, workers) - wątki robocze, ostatnia - wspólna
+    std::vector<std::thread> workers_;
+    int firstCpu_;
+    std::atomic<int> queued_{0};
+    std::atomic<bool> stop_{false};
+    std::mutex sleepMutex_;
+    std::condition_variable wake_;
+};
+
+/**
+ * Grupa zadań, na które można poczekać. Bez puli (pool == nullptr) zadania
+ * wykonywane są od razu, w wątku wywołującym - ten sam kod obsługuje więc
+ * wersję równoległą i sekwencyjną. Pierwszy wyjątek z zadania jest
+ * rzucany ponownie z wait().
+ */
+class TaskGroup {
+public:
+    explicit TaskGroup(ThreadPool *pool) : pool_(pool) {}
+    ~TaskGroup();
+
+    TaskGroup(const TaskGroup &) = delete;
+    TaskGroup &operator=(const TaskGroup &) = delete;
+
+    // Bez puli zadanie wołane jest bezpośrednio - bez opakowania w std::function
+    // (i alokacji na stercie, gdy lambda przechwytuje więcej niż kilka referencji)
+    template <typename F>
+    void run(F &&task) {
+        if (!pool_) {
+            task();
+            return;
+        }
+        submit(std::function<void()>(std::forward<F>(task)));
+    }
+
+    void wait();
+
+private:
+    // tyle nieudanych prób runOne (z yield) przed zaśnięciem w join()
+    static constexpr int kJoinSpins = 64;
+
+    void submit(std::function<void()> task);
+    void join();
+
+    ThreadPool *pool_;
+    std::atomic<int> pending_{0};
+    std::mutex errorMutex_;
+    std::exception_ptr error_;
+};
+
+// Wspólna pula; domyślny rozmiar z MATRIX_THREADS albo liczby rdzeni
+ThreadPool &threadPool();
+void threadPoolSetSize(int threads, int firstCpu = -1);
+int threadPoolSize();
+
+// Najmniejsza głębokość d, dla której branching^d >= 4 * threads
+// (0 dla jednego wątku) - tyle poziomów rekurencji warto zrównoleglić.
+int parallelDepthFor(int branching, int threads);
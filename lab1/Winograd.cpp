@@ -0,0 +1,204 @@
+#include "Winograd.h"
+#include "SupportFunctions.h"
+#include "Gemm.h"
+#include "Arena.h"
+
+#include <algorithm>
+
+#include <stdexcept>
+#include <memory>
+
+namespace {
+
+// Liść rekurencji: któryś wymiar <= leafSize albo równy 1
+bool isLeaf(int m, int k, int n, int leafSize) {
+    return std::min({m, k, n}) <= std::max(leafSize, 1);
+}
+
+// Najdłuższy wymiar do podziału na połowy, gdy jest > 2x najkrótszy
+// (0 - wiersze A, 1 - wspólny, 2 - kolumny B), -1 dla kształtu bliskiego kwadratowi
+int splitDimension(int m, int k, int n) {
+    int longest = std::max({m, k, n});
+    if (longest <= 2 * std::min({m, k, n})) return -1;
+    return longest == m ? 0 : longest == n ? 2 : 1;
+}
+
+// Elementy areny potrzebne na bufory X i Y wszystkich poziomów rekurencji
+// (X mieści sumę bloków A i iloczyn P1) oraz na drugą połowę przy podziale k
+std::size_t scratchSize(int m, int k, int n, int leafSize) {
+    if (isLeaf(m, k, n, leafSize)) return 0;
+    switch (splitDimension(m, k, n)) {
+        case 0: return scratchSize(m - m / 2, k, n, leafSize);
+        case 1: return Arena::footprint(m, n) + scratchSize(m, k - k / 2, n, leafSize);
+        case 2: return scratchSize(m, k, n - n / 2, leafSize);
+        default: break;
+    }
+    if (m % 2 == 1 || k % 2 == 1 || n % 2 == 1) return scratchSize(m & ~1, k & ~1, n & ~1, leafSize);
+    int hm = m / 2, hk = k / 2, hn = n / 2;
+    return Arena::footprint(hm, std::max(hk, hn)) + Arena::footprint(hk, hn) + scratchSize(hm, hk, hn, leafSize);
+}
+
+// C = alpha * op(A) * op(B) dla dowolnych m x k * k x n (alpha w liściach
+// i raz na poziom Winograda, po złożeniu C). Kształt wydłużony dzielony jest na połowy wzdłuż najdłuższego
+// wymiaru (jak w Strassen.cpp), bliski kwadratowi - poziom Winograda. Poziom
+// bierze X i Y z areny wątku i oddaje je przy wyjściu, więc głębsze poziomy
+// zajmują kolejne fragmenty tego samego bloku.
+void multiplyRec(ConstMatrixView A, ConstMatrixView B, MatrixView C, const GemmForm &form, int leafSize) {
+    int m = opRows(A, form.opA), k = opCols(A, form.opA), n = opCols(B, form.opB);
+    if (k != opRows(B, form.opB)) {
+        throw std::runtime_error("Incompatible dimensions for multiplication");
+    }
+
+    if (m == 1 && k == 1 && n == 1 && form.plain()) {
+        multiplyInto(A, B, C);
+        return;
+    }
+    if (isLeaf(m, k, n, leafSize)) {
+        gemm(C, form, A, B, false);
+        return;
+    }
+
+    switch (splitDimension(m, k, n)) {
+        case 0:
+            multiplyRec(opBlock(A, form.opA, 0, 0, m / 2, k), B, C.block(0, 0, m / 2, n), form, leafSize);
+            multiplyRec(opBlock(A, form.opA, m / 2, 0, m - m / 2, k), B, C.block(m / 2, 0, m - m / 2, n), form, leafSize);
+            return;
+        case 2:
+            multiplyRec(A, opBlock(B, form.opB, 0, 0, k, n / 2), C.block(0, 0, m, n / 2), form, leafSize);
+            multiplyRec(A, opBlock(B, form.opB, 0, n / 2, k, n - n / 2), C.block(0, n / 2, m, n - n / 2), form, leafSize);
+            return;
+        case 1: {
+            // C = A1 * B1 + A2 * B2, drugi iloczyn w buforze
+            memCounterEnterCall(static_cast<std::size_t>(m), static_cast<std::size_t>(n), 1);
+            Arena &arena = threadArena();
+            Arena::Scope scope(arena);
+            MatrixView T = arena.allocate(m, n);
+            multiplyRec(opBlock(A, form.opA, 0, 0, m, k / 2), opBlock(B, form.opB, 0, 0, k / 2, n), C, form, leafSize);
+            multiplyRec(opBlock(A, form.opA, 0, k / 2, m, k - k / 2), opBlock(B, form.opB, k / 2, 0, k - k / 2, n), T, form,
+                        leafSize);
+            addAssign(C, T);
+            memCounterExitCall(static_cast<std::size_t>(m), static_cast<std::size_t>(n), 1);
+            return;
+        }
+        default: break;
+    }
+
+    if (m % 2 == 1 || k % 2 == 1 || n % 2 == 1) {
+        // dynamic peeling, tak jak w Strassen.cpp
+        memCounterEnterCall(static_cast<std::size_t>(m), static_cast<std::size_t>(n), 0);
+
+        int mc = m & ~1, kc = k & ~1, nc = n & ~1;
+        MatrixView C11 = C.block(0, 0, mc, nc);
+
+        multiplyRec(opBlock(A, form.opA, 0, 0, mc, kc), opBlock(B, form.opB, 0, 0, kc, nc), C11, form, leafSize);
+        if (kc < k) gemm(C11, form, opBlock(A, form.opA, 0, kc, mc, 1), opBlock(B, form.opB, kc, 0, 1, nc), true);
+        if (nc < n) gemm(C.block(0, nc, mc, 1), form, opBlock(A, form.opA, 0, 0, mc, k), opBlock(B, form.opB, 0, nc, k, 1), false);
+        if (mc < m) gemm(C.block(mc, 0, 1, n), form, opBlock(A, form.opA, mc, 0, 1, k), B, false);
+
+        memCounterExitCall(static_cast<std::size_t>(m), static_cast<std::size_t>(n), 0);
+        return;
+    }
+
+    int hm = m / 2, hk = k / 2, hn = n / 2;
+    memCounterEnterCall(static_cast<std::size_t>(hm), static_cast<std::size_t>(hn), 2);
+
+    ConstMatrixView A11 = opBlock(A, form.opA, 0, 0, hm, hk);
+    ConstMatrixView A12 = opBlock(A, form.opA, 0, hk, hm, hk);
+    ConstMatrixView A21 = opBlock(A, form.opA, hm, 0, hm, hk);
+    ConstMatrixView A22 = opBlock(A, form.opA, hm, hk, hm, hk);
+
+    ConstMatrixView B11 = opBlock(B, form.opB, 0, 0, hk, hn);
+    ConstMatrixView B12 = opBlock(B, form.opB, 0, hn, hk, hn);
+    ConstMatrixView B21 = opBlock(B, form.opB, hk, 0, hk, hn);
+    ConstMatrixView B22 = opBlock(B, form.opB, hk, hn, hk, hn);
+
+    MatrixView C11 = C.block(0, 0, hm, hn);
+    MatrixView C12 = C.block(0, hn, hm, hn);
+    MatrixView C21 = C.block(hm, 0, hm, hn);
+    MatrixView C22 = C.block(hm, hn, hm, hn);
+
+    // X to najpierw sumy bloków A (hm x hk, w układzie A), potem iloczyn P1 (hm x hn)
+    Arena &arena = threadArena();
+    Arena::Scope scope(arena);
+    double *xbuf = arena.allocate(static_cast<std::size_t>(hm) * std::max(hk, hn));
+    MatrixView X(xbuf, A11.rows, A11.cols, A11.cols);
+    MatrixView P1(xbuf, hm, hn, hn);
+    MatrixView Y = arena.allocate(B11.rows, B11.cols);
+    GemmForm inner{form.opA, form.opB, 1.0};
+
+    // S1 = A21 + A22, S2 = S1 - A11, S3 = A11 - A21, S4 = A12 - S2
+    // T1 = B12 - B11, T2 = B22 - T1, T3 = B22 - B12, T4 = T2 - B21
+    // P1 = A11 B11, P2 = A12 B21, P3 = S4 B22, P4 = A22 T4,
+    // P5 = S1 T1,   P6 = S2 T2,   P7 = S3 T3
+    // C11 = P1 + P2, U2 = P1 + P6, U3 = U2 + P7, C12 = U2 + P5 + P3,
+    // C21 = U3 - P4, C22 = U3 + P5
+    subInto(A11, A21, X);                          // X = S3
+    subInto(B22, B12, Y);                          // Y = T3
+    multiplyRec(X, Y, C21, inner, leafSize);       // C21 = P7
+    addInto(A21, A22, X);                          // X = S1
+    subInto(B12, B11, Y);                          // Y = T1
+    multiplyRec(X, Y, C22, inner, leafSize);       // C22 = P5
+    subInto(X, A11, X);                            // X = S2
+    subInto(B22, Y, Y);                            // Y = T2
+    multiplyRec(X, Y, C12, inner, leafSize);       // C12 = P6
+    subInto(A12, X, X);                            // X = S4
+    multiplyRec(X, B22, C11, inner, leafSize);     // C11 = P3
+    multiplyRec(A11, B11, P1, inner, leafSize);    // X = P1
+    addAssign(C12, P1);                            // C12 = U2
+    addAssign(C21, C12);                           // C21 = U3
+    addAssign(C12, C22);                           // C12 = U2 + P5
+    addAssign(C22, C21);                           // C22 = U3 + P5
+    addAssign(C12, C11);                           // C12 = U2 + P5 + P3
+    subInto(Y, B21, Y);                            // Y = T4
+    multiplyRec(A22, Y, C11, inner, leafSize);     // C11 = P4
+    subAssign(C21, C11);                           // C21 = U3 - P4
+    multiplyRec(A12, B21, C11, inner, leafSize);   // C11 = P2
+    addAssign(C11, P1);                            // C11 = P1 + P2
+    scaleAssign(C, form.alpha);
+
+    memCounterExitCall(static_cast<std::size_t>(hm), static_cast<std::size_t>(hn), 2);
+}
+
+} // namespace
+
+class WinogradImpl : public IMnozenie {
+public:
+    explicit WinogradImpl(int leafSize) : leafSize(leafSize) {}
+
+    void multiplyInto(ConstMatrixView A, ConstMatrixView B, MatrixView C) override {
+        Arena &arena = threadArena();
+        Arena::Scope scope(arena);
+        arena.reserve(scratchSize(A.rows, A.cols, B.cols, leafSize));
+        multiplyRec(A, B, C, GemmForm{}, leafSize);
+    }
+
+    // Poziom Winograda trzyma iloczyny pośrednie w blokach C, więc przy
+    // beta != 0 iloczyn liczony jest w buforze areny i dopiero dodawany do C
+    void multiplyAdd(MatrixView C, double alpha, ConstMatrixView A, ConstMatrixView B, double beta,
+                     Op opA, Op opB) override {
+        if (alpha == 0.0) {
+            scaleAssign(C, beta);
+            return;
+        }
+        int m = opRows(A, opA), k = opCols(A, opA), n = opCols(B, opB);
+        Arena &arena = threadArena();
+        Arena::Scope scope(arena);
+        if (beta == 0.0) {
+            arena.reserve(scratchSize(m, k, n, leafSize));
+            multiplyRec(A, B, C, GemmForm{opA, opB, alpha}, leafSize);
+            return;
+        }
+        arena.reserve(Arena::footprint(m, n) + scratchSize(m, k, n, leafSize));
+        MatrixView P = arena.allocate(m, n);
+        multiplyRec(A, B, P, GemmForm{opA, opB, alpha}, leafSize);
+        scaleAssign(C, beta);
+        addAssign(C, P);
+    }
+
+private:
+    int leafSize;
+};
+
+std::unique_ptr<IMnozenie> createWinograd(int leafSize) {
+    return std::make_unique<WinogradImpl>(leafSize);
+}
@@ -0,0 +1,18 @@
+#pragma once
+
+#include "Mnozenie.h"
+#include <memory>
+
+/**
+ * Fabryka zwracająca implementację IMnozenie opartą o wariant Winograda
+ * algorytmu Strassena: 7 mnożeń i 15 dodawań bloków na poziom (zamiast 18).
+ *
+ * Iloczyny zapisywane są od razu do ćwiartek C, więc na poziom potrzebne są
+ * tylko dwa bufory tymczasowe rozmiaru ćwiartki. Bufory wszystkich poziomów
+ * pochodzą z areny wątku (Arena.h), rezerwowanej raz na całe mnożenie.
+ * Podproblemy, w których któryś wymiar jest <= leafSize, liczone są blokowym
+ * gemm. Obsługuje dowolne m x k * k x n: kształt wydłużony (najdłuższy wymiar
+ * > 2x najkrótszy) dzielony jest na połowy wzdłuż najdłuższego wymiaru,
+ * nieparzyste wymiary - dynamic peeling.
+ */
+std::unique_ptr<IMnozenie> createWinograd(int leafSize = 64);
@@ -0,0 +1,141 @@
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "SupportFunctions.h"
+#include "Mnozenie.h"
+#include "Binet.h"
+#include "Strassen.h"
+#include "AI.h"
+#include "Gemm.h"
+#include "Winograd.h"
+#include "ThreadPool.h"
+#include "Benchmark.h"
+#include "Auto.h"
+#include "BatchedGemm.h"
+#include "BilinearScheme.h"
+
+// Liczba operacji jednego uruchomienia z liczników (jedno dodatkowe, niemierzone
+// wywołanie); w wersji fast liczniki są wyłączone i używane jest fallback.
+static double countFlops(const std::function<void()> &run, double fallback) {
+    if (!instrumentationEnabled) return fallback;
+    opCounterReset();
+    run();
+    OpCounts ops = opCounterGet();
+    return static_cast<double>(ops.adds + ops.subs + ops.muls + ops.divs);
+}
+
+int main(int argc, char **argv) {
+    BenchConfig config;
+    try {
+        config = parseBenchArgs(argc, argv, {128, 256, 512, 1024});
+    } catch (const std::exception &e) {
+        std::cerr << e.what() << "\n"
+                  << "Uzycie: " << argv[0] << " [--warmup W] [--reps R] [--cpu C] [--threads T]"
+                  << " [--format csv|json] [--out PLIK] [N...]\n";
+        return 1;
+    }
+
+    if (config.cpu >= 0 && !pinCurrentThread(config.cpu)) {
+        std::cerr << "Nie udalo sie przypiac watku do rdzenia " << config.cpu << "\n";
+    }
+    threadPoolSetSize(config.threads, config.cpu);
+
+    struct Backend {
+        std::string name;
+        std::unique_ptr<IMnozenie> impl;
+    };
+    std::vector<Backend> backends;
+    backends.push_back({"binet", createBinet(64, parallelDepthFor(4, config.threads))});
+    backends.push_back({"strassen", createStrassen(64, parallelDepthFor(7, config.threads))});
+    backends.push_back({"winograd", createWinograd()});
+    backends.push_back({"gemm", createGemm()});
+    backends.push_back({"auto", createAuto("autotune.txt", config.threads)});
+    // schematy dwuliniowe z Schemes.h przez ogólny silnik rekurencyjny
+    for (const char *scheme : {"strassen", "laderman", "ai455"}) {
+        backends.push_back({std::string("scheme_") + scheme, createScheme(builtinScheme(scheme))});
+    }
+
+    std::vector<BenchResult> results;
+    for (int n : config.sizes) {
+        Matrix A = createRandomMatrix(n);
+        Matrix B = createRandomMatrix(n);
+        Matrix C(n, n);
+        for (Backend &b : backends) {
+            auto run = [&] { b.impl->multiplyInto(A, B, C); };
+            double nominal = 2.0 * n * n * n;
+            results.push_back(runBenchmark(b.name, n, config, run, countFlops(run, nominal)));
+        }
+    }
+
+    // AI obsługuje tylko 4x5 * 5x5 - jeden przypadek niezależnie od rozmiarów
+    {
+        auto ai = createAI();
+        Matrix A = createRandomMatrix(4, 5);
+        Matrix B = createRandomMatrix(5, 5);
+        Matrix C(4, 5);
+        auto run = [&] { ai->multiplyInto(A, B, C); };
+        results.push_back(runBenchmark("ai_4x5x5", 4, config, run, countFlops(run, 2.0 * 4 * 5 * 5)));
+
+        // 1024 niezależnych iloczynów: harmonogram na pasach SIMD kontra pętla
+        const int count = 1024;
+        std::vector<Matrix> As, Bs, Cs;
+        std::vector<ConstMatrixView> a, b;
+        std::vector<MatrixView> c;
+        for (int i = 0; i < count; ++i) {
+            As.push_back(createRandomMatrix(4, 5));
+            Bs.push_back(createRandomMatrix(5, 5));
+            Cs.emplace_back(4, 5);
+        }
+        for (int i = 0; i < count; ++i) {
+            a.push_back(As[i]);
+            b.push_back(Bs[i]);
+            c.push_back(Cs[i]);
+        }
+        auto batched = [&] { aiBatched(count, a.data(), b.data(), c.data()); };
+        auto single = [&] {
+            for (int i = 0; i < count; ++i) ai->multiplyInto(a[i], b[i], c[i]);
+        };
+        double flops = 2.0 * 4 * 5 * 5 * count;
+        results.push_back(runBenchmark("ai_4x5x5_batched_x1024", 4, config, batched, countFlops(batched, flops)));
+        results.push_back(runBenchmark("ai_4x5x5_loop_x1024", 4, config, single, countFlops(single, flops)));
+    }
+
+    // Wsadowo: 1024 małych problemów tego samego kształtu - gemmBatched
+    // kontra pętla wywołań IMnozenie (gemm) po jednym problemie
+    {
+        const int count = 1024;
+        auto loop = createGemm();
+        for (int n : {2, 4, 8, 16}) {
+            std::vector<Matrix> A, B, C;
+            std::vector<ConstMatrixView> a, b;
+            std::vector<MatrixView> c;
+            for (int i = 0; i < count; ++i) {
+                A.push_back(createRandomMatrix(n));
+                B.push_back(createRandomMatrix(n));
+                C.emplace_back(n, n);
+            }
+            for (int i = 0; i < count; ++i) {
+                a.push_back(A[i]);
+                b.push_back(B[i]);
+                c.push_back(C[i]);
+            }
+            double flops = 2.0 * n * n * n * count;
+            auto batched = [&] { gemmBatched(count, a.data(), b.data(), c.data()); };
+            auto single = [&] {
+                for (int i = 0; i < count; ++i) loop->multiplyInto(a[i], b[i], c[i]);
+            };
+            results.push_back(runBenchmark("batched_x1024", n, config, batched, flops));
+            results.push_back(runBenchmark("loop_x1024", n, config, single, flops));
+        }
+    }
+
+    try {
+        writeBenchResults(config, results);
+    } catch (const std::exception &e) {
+        std::cerr << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
@@ -13,6 +13,12 @@
 #include "Binet.h"
 #include "Strassen.h"
 #include "AI.h"
+#include "Gemm.h"
+#include "Winograd.h"
+#include "ThreadPool.h"
+#include "Auto.h"
+#include "PerfCounters.h"
+#include "BilinearScheme.h"
 
 int main(int argc, char** argv) {
     if (argc >= 2) { //batch mode
@@ -39,9 +45,50 @@ int main(int argc, char** argv) {
             return 1;
         }
 
+        // Liczniki sprzętowe (MATRIX_PERF=1) otwierane przed utworzeniem puli,
+        // żeby obejmowały też wątki robocze
+        PerfCounters perf(perfCountersRequested());
+
+        // Opcjonalny drugi argument: rozmiar liścia rekurencji (liczba albo
+        // "auto" - dobierany pomiarem). 1 oznacza rekurencję aż do 1x1.
+        int leafSize = 0;
+        if (argc >= 3) {
+            std::string leaf = argv[2];
+            if (leaf == "auto") {
+                std::cout << "Dobieranie rozmiaru liscia Strassena... ";
+                std::cout.flush();
+                leafSize = tuneStrassenLeafSize();
+                std::cout << leafSize << "\n";
+            } else {
+                try {
+                    leafSize = std::stoi(leaf);
+                } catch (...) {
+                    std::cerr << "Niepoprawny rozmiar liscia: " << leaf << "\n";
+                    return 1;
+                }
+            }
+        }
+
+        // Opcjonalny trzeci argument: liczba wątków puli. Rekurencja jest
+        // zrównoleglana do głębokości dającej kilka zadań na wątek.
+        int threads = 1;
+        if (argc >= 4) {
+            try {
+                threads = std::stoi(argv[3]);
+            } catch (...) {
+                threads = 0;
+            }
+            if (threads < 1) {
+                std::cerr << "Niepoprawna liczba watkow: " << argv[3] << "\n";
+                return 1;
+            }
+            threadPoolSetSize(threads);
+        }
+        if (leafSize <= 0) leafSize = 64;
+
         // Create both implementations
-        auto binetImpl = createBinet();
-        auto strassenImpl = createStrassen();
+        auto binetImpl = createBinet(leafSize, parallelDepthFor(4, threads));
+        auto strassenImpl = createStrassen(leafSize, parallelDepthFor(7, threads));
 
         // Open output files
         std::ofstream outBinet("wynikBinet.txt");
@@ -51,11 +98,13 @@ int main(int argc, char** argv) {
             return 1;
         }
 
-        outBinet << "# N czas_s adds subs muls divs peak_bytes peak_calls\n";
-        outStrassen << "# N czas_s adds subs muls divs peak_bytes peak_calls\n";
+        outBinet << "# N czas_s adds subs muls divs peak_bytes peak_calls arena_peak_bytes alloc_peak_bytes alloc_count alloc_hist cycles instructions l1d_misses llc_misses fp_ops\n";
+        outStrassen << "# N czas_s adds subs muls divs peak_bytes peak_calls arena_peak_bytes alloc_peak_bytes alloc_count alloc_hist cycles instructions l1d_misses llc_misses fp_ops\n";
 
         std::cout << "\n========================================\n";
         std::cout << "Rozpoczynam obliczenia dla " << sizes.size() << " rozmiarow macierzy\n";
+        if (!instrumentationEnabled) std::cout << "(wersja fast - liczniki operacji i pamieci wylaczone)\n";
+        if (perfCountersRequested() && !perf.available()) std::cout << "(liczniki sprzetowe perf niedostepne - kolumny perf to \"-\")\n";
         std::cout << "========================================\n\n";
 
         // Process each size alternating between Binet and Strassen
@@ -68,9 +117,9 @@ int main(int argc, char** argv) {
 
             auto A = createRandomMatrix(N);
             auto B = createRandomMatrix(N);
-            if ((int)A.size() != N || (int)B.size() != N) {
-                outBinet << N << " " << -1 << " 0 0 0 0 0 0\n";
-                outStrassen << N << " " << -1 << " 0 0 0 0 0 0\n";
+            if (rows(A) != N || rows(B) != N) {
+                outBinet << N << " " << -1 << " 0 0 0 0 0 0 0 0 0 - - - - - -\n";
+                outStrassen << N << " " << -1 << " 0 0 0 0 0 0 0 0 0 - - - - - -\n";
                 std::cout << "BLAD (tworzenie macierzy)\n";
                 continue;
             }
@@ -85,16 +134,21 @@ int main(int argc, char** argv) {
                 
                 opCounterReset();
                 memCounterReset();
+                perf.start();
                 auto t0 = std::chrono::high_resolution_clock::now();
                 Matrix C = binetImpl->multiply(A, B);
                 auto t1 = std::chrono::high_resolution_clock::now();
+                PerfSample ps = perf.stop();
                 OpCounts ops = opCounterGet();
                 MemStats ms = memCounterGet();
+                AllocStats as = allocCounterGet();
                 std::chrono::duration<double> elapsed = t1 - t0;
 
                 outBinet << N << " " << std::fixed << std::setprecision(6) << elapsed.count()
                     << " " << ops.adds << " " << ops.subs << " " << ops.muls << " " << ops.divs
-                    << " " << ms.peak_bytes << " " << ms.peak_calls << "\n";
+                    << " " << ms.peak_bytes << " " << ms.peak_calls << " " << ms.arena_peak_bytes
+                    << " " << as.peak_bytes << " " << as.alloc_count << " " << allocHistogramString(as)
+                    << " " << perfSampleString(ps) << "\n";
                 outBinet.flush();
 
                 std::cout << std::fixed << std::setprecision(3) << elapsed.count() << "s | ";
@@ -106,16 +160,21 @@ int main(int argc, char** argv) {
                 
                 opCounterReset();
                 memCounterReset();
+                perf.start();
                 t0 = std::chrono::high_resolution_clock::now();
                 C = strassenImpl->multiply(A, B);
                 t1 = std::chrono::high_resolution_clock::now();
+                ps = perf.stop();
                 ops = opCounterGet();
                 ms = memCounterGet();
+                as = allocCounterGet();
                 elapsed = t1 - t0;
 
                 outStrassen << N << " " << std::fixed << std::setprecision(6) << elapsed.count()
                     << " " << ops.adds << " " << ops.subs << " " << ops.muls << " " << ops.divs
-                    << " " << ms.peak_bytes << " " << ms.peak_calls << "\n";
+                    << " " << ms.peak_bytes << " " << ms.peak_calls << " " << ms.arena_peak_bytes
+                    << " " << as.peak_bytes << " " << as.alloc_count << " " << allocHistogramString(as)
+                    << " " << perfSampleString(ps) << "\n";
                 outStrassen.flush();
 
                 std::cout << std::fixed << std::setprecision(3) << elapsed.count() << "s";
@@ -127,16 +186,21 @@ int main(int argc, char** argv) {
                 
                 opCounterReset();
                 memCounterReset();
+                perf.start();
                 auto t0 = std::chrono::high_resolution_clock::now();
                 Matrix C = strassenImpl->multiply(A, B);
                 auto t1 = std::chrono::high_resolution_clock::now();
+                PerfSample ps = perf.stop();
                 OpCounts ops = opCounterGet();
                 MemStats ms = memCounterGet();
+                AllocStats as = allocCounterGet();
                 std::chrono::duration<double> elapsed = t1 - t0;
 
                 outStrassen << N << " " << std::fixed << std::setprecision(6) << elapsed.count()
                     << " " << ops.adds << " " << ops.subs << " " << ops.muls << " " << ops.divs
-                    << " " << ms.peak_bytes << " " << ms.peak_calls << "\n";
+                    << " " << ms.peak_bytes << " " << ms.peak_calls << " " << ms.arena_peak_bytes
+                    << " " << as.peak_bytes << " " << as.alloc_count << " " << allocHistogramString(as)
+                    << " " << perfSampleString(ps) << "\n";
                 outStrassen.flush();
 
                 std::cout << std::fixed << std::setprecision(3) << elapsed.count() << "s | ";
@@ -148,16 +212,21 @@ int main(int argc, char** argv) {
                 
                 opCounterReset();
                 memCounterReset();
+                perf.start();
                 t0 = std::chrono::high_resolution_clock::now();
                 C = binetImpl->multiply(A, B);
                 t1 = std::chrono::high_resolution_clock::now();
+                ps = perf.stop();
                 ops = opCounterGet();
                 ms = memCounterGet();
+                as = allocCounterGet();
                 elapsed = t1 - t0;
 
                 outBinet << N << " " << std::fixed << std::setprecision(6) << elapsed.count()
                     << " " << ops.adds << " " << ops.subs << " " << ops.muls << " " << ops.divs
-                    << " " << ms.peak_bytes << " " << ms.peak_calls << "\n";
+                    << " " << ms.peak_bytes << " " << ms.peak_calls << " " << ms.arena_peak_bytes
+                    << " " << as.peak_bytes << " " << as.alloc_count << " " << allocHistogramString(as)
+                    << " " << perfSampleString(ps) << "\n";
                 outBinet.flush();
 
                 std::cout << std::fixed << std::setprecision(3) << elapsed.count() << "s";
@@ -189,6 +258,10 @@ int main(int argc, char** argv) {
         std::cout << "1) Binet (rekurencyjnie bez padowania)\n";
         std::cout << "2) Strassen\n";
         std::cout << "3) AI\n";
+        std::cout << "4) GEMM (blokowe, w stylu GotoBLAS)\n";
+        std::cout << "5) Strassen-Winograd\n";
+        std::cout << "6) Auto (najszybszy backend dla ksztaltu, tabela autotune.txt)\n";
+        std::cout << "7) Schemat dwuliniowy rekurencyjnie (strassen, laderman, ai455 albo katalog multa/multb/multc)\n";
         std::cout << "Wybor (domyslnie 1): ";
         if (!(std::cin >> choice)) choice = 1;
 
@@ -203,6 +276,35 @@ int main(int argc, char** argv) {
             case 3:
                 impl = createAI();
                 break;
+            case 4:
+                impl = createGemm();
+                break;
+            case 5:
+                impl = createWinograd();
+                break;
+            case 6:
+                std::cout << "Strojenie / wczytywanie tabeli autotune.txt...\n";
+                impl = createAuto();
+                break;
+            case 7: {
+                std::string name;
+                std::cout << "Schemat (nazwa albo katalog): ";
+                std::cin >> name;
+                try {
+                    if (name == "strassen" || name == "laderman" || name == "ai455") {
+                        impl = createScheme(builtinScheme(name));
+                    } else {
+                        int m = 0, k = 0, n = 0;
+                        std::cout << "Wymiary schematu m k n: ";
+                        std::cin >> m >> k >> n;
+                        impl = createScheme(loadScheme(name, m, k, n));
+                    }
+                } catch (const std::exception &e) {
+                    std::cerr << e.what() << ". Uzywam Binet (1).\n";
+                    impl = createBinet();
+                }
+                break;
+            }
             default:
                 std::cerr << "Wybrana metoda (" << choice << ") niezaimplementowana. Uzywam Binet (1).\n";
                 impl = createBinet();
@@ -223,12 +325,16 @@ int main(int argc, char** argv) {
         auto t1 = std::chrono::high_resolution_clock::now();
         OpCounts ops = opCounterGet();
         MemStats ms = memCounterGet();
+        AllocStats as = allocCounterGet();
         std::chrono::duration<double> elapsed = t1 - t0;
 
         std::cout << "Czas (s): " << std::fixed << std::setprecision(6) << elapsed.count() << "\n";
         std::cout << "Op counts: adds=" << ops.adds << " subs=" << ops.subs
                     << " muls=" << ops.muls << " divs=" << ops.divs << "\n";
-        std::cout << "Memory (bytes): peak=" << ms.peak_bytes << " (peak calls=" << ms.peak_calls << ")\n";
+        std::cout << "Memory (bytes): peak=" << ms.peak_bytes << " (peak calls=" << ms.peak_calls << ")"
+                    << ", arena peak=" << ms.arena_peak_bytes << "\n";
+        std::cout << "Allocations: peak=" << as.peak_bytes << " count=" << as.alloc_count
+                    << " sizes(log2:count)=" << allocHistogramString(as) << "\n";
 
         Matrix C_ref = A * B;
         auto [ok, maxdiff] = compareMatrices(C, C_ref, 1e-9);
@@ -0,0 +1,196 @@
+#include "SupportFunctions.h"
+#include "AI.h"
+#include "Auto.h"
+#include "BatchedGemm.h"
+#include "BilinearScheme.h"
+#include "Binet.h"
+#include "Gemm.h"
+#include "Strassen.h"
+#include "ThreadPool.h"
+#include "Winograd.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// Test poprawności wszystkich implementacji IMnozenie (make test).
+// Każdy backend liczy iloczyny kształtów nieparzystych, prostokątnych
+// i niebędących potęgami dwójki, porównywane z naiwnym iloczynem (operator*).
+// Błąd względny: max |C - C_ref| / (k * max|A| * max|B|). Kod wyjścia 1,
+// gdy któryś przypadek przekroczy tolerancję.
+
+namespace {
+
+// Strassen/Winograd gubią kilka cyfr na poziom rekurencji - zapas na ~5 poziomów
+constexpr double kProductTol = 1e-10;
+
+struct Shape {
+    int m, k, n;
+};
+
+const std::vector<Shape> kShapes = {
+    {1, 1, 1},    {2, 3, 4},     {5, 7, 3},      {17, 17, 17},   {31, 64, 33},    {64, 64, 64},
+    {65, 65, 65}, {100, 37, 129}, {129, 200, 70}, {200, 3, 150}, {255, 256, 257}, {300, 300, 300},
+};
+
+int failures = 0;
+
+double maxAbs(ConstMatrixView X) {
+    double m = 0.0;
+    for (int i = 0; i < X.rows; ++i)
+        for (int j = 0; j < X.cols; ++j) m = std::max(m, std::fabs(X[i][j]));
+    return m;
+}
+
+double maxDiff(ConstMatrixView X, ConstMatrixView Y) {
+    double m = 0.0;
+    for (int i = 0; i < X.rows; ++i)
+        for (int j = 0; j < X.cols; ++j) m = std::max(m, std::fabs(X[i][j] - Y[i][j]));
+    return m;
+}
+
+double productError(ConstMatrixView C, ConstMatrixView ref, ConstMatrixView A, ConstMatrixView B) {
+    double scale = std::max(1, A.cols) * maxAbs(A) * maxAbs(B);
+    return maxDiff(C, ref) / (scale > 0.0 ? scale : 1.0);
+}
+
+// Wypisuje tylko przypadki poza tolerancją (NaN też); zwraca błąd
+double check(const std::string &what, double err, double tol) {
+    if (!(err <= tol)) {
+        ++failures;
+        std::cout << "  BŁĄD " << what << ": błąd względny " << std::scientific << std::setprecision(2) << err
+                  << std::defaultfloat << "\n";
+    }
+    return err;
+}
+
+// Największy błąd względny grupy przypadków
+void report(const std::string &name, double worst) {
+    std::cout << "  " << std::scientific << std::setprecision(2) << worst << std::defaultfloat << "  " << name
+              << "\n";
+}
+
+std::string shapeName(const Shape &s) {
+    return std::to_string(s.m) + "x" + std::to_string(s.k) + "*" + std::to_string(s.k) + "x" + std::to_string(s.n);
+}
+
+// multiplyInto oraz multiplyAdd z transpozycjami (C = 2 A^T B^T - C) dla wszystkich kształtów
+void testBackend(const std::string &name, IMnozenie &impl, const std::vector<Shape> &shapes) {
+    double worst = 0.0;
+    for (const Shape &s : shapes) {
+        Matrix A = createRandomMatrix(s.m, s.k), B = createRandomMatrix(s.k, s.n);
+        Matrix ref = A * B;
+        worst = std::max(worst, check(name + " " + shapeName(s), productError(impl.multiply(A, B), ref, A, B),
+                                      kProductTol));
+
+        Matrix At = zeroMatrix(s.k, s.m), Bt = zeroMatrix(s.n, s.k);
+        transposeInto(A, At);
+        transposeInto(B, Bt);
+        Matrix C = createRandomMatrix(s.m, s.n), expected = zeroMatrix(s.m, s.n);
+        for (int i = 0; i < s.m; ++i)
+            for (int j = 0; j < s.n; ++j) expected[i][j] = 2.0 * ref[i][j] - C[i][j];
+        impl.multiplyAdd(C, 2.0, At, Bt, -1.0, Op::Trans, Op::Trans);
+        worst = std::max(worst, check(name + " multiplyAdd " + shapeName(s), productError(C, expected, A, B) / 2.0,
+                                      kProductTol));
+    }
+    report(name, worst);
+}
+
+void testBatched() {
+    double worst = 0.0;
+    for (int s = 1; s <= kSmallGemmMax; ++s) {
+        for (int count : {1, 3, 8, 21}) {
+            std::vector<Matrix> A, B, C;
+            for (int i = 0; i < count; ++i) {
+                A.push_back(createRandomMatrix(s, s + 1));
+                B.push_back(createRandomMatrix(s + 1, s));
+                C.push_back(zeroMatrix(s, s));
+            }
+            std::vector<ConstMatrixView> a(A.begin(), A.end()), b(B.begin(), B.end());
+            std::vector<MatrixView> c(C.begin(), C.end());
+            gemmBatched(count, a.data(), b.data(), c.data());
+            for (int i = 0; i < count; ++i) {
+                worst = std::max(worst, check("gemmBatched " + std::to_string(s) + " x" + std::to_string(count),
+                                              productError(C[i], A[i] * B[i], A[i], B[i]), kProductTol));
+            }
+        }
+    }
+
+    for (int count : {1, 7, 8, 13}) {
+        std::vector<Matrix> A, B, C;
+        for (int i = 0; i < count; ++i) {
+            A.push_back(createRandomMatrix(4, 5));
+            B.push_back(createRandomMatrix(5, 5));
+            C.push_back(zeroMatrix(4, 5));
+        }
+        std::vector<ConstMatrixView> a(A.begin(), A.end()), b(B.begin(), B.end());
+        std::vector<MatrixView> c(C.begin(), C.end());
+        aiBatched(count, a.data(), b.data(), c.data());
+        for (int i = 0; i < count; ++i) {
+            worst = std::max(worst, check("aiBatched x" + std::to_string(count),
+                                          productError(C[i], A[i] * B[i], A[i], B[i]), kProductTol));
+        }
+    }
+    report("gemmBatched / aiBatched", worst);
+}
+
+// Schemat złożony ręcznie z wymiarem > 9 - createScheme ma go odrzucić
+void testSchemeLimits() {
+    BilinearScheme s;
+    s.name = "10x1x10";
+    s.m = 10;
+    s.k = 1;
+    s.n = 10;
+    s.rank = 100;
+    s.U.assign(s.rank * s.m * s.k, 0);
+    s.V.assign(s.rank * s.k * s.n, 0);
+    s.W.assign(s.m * s.n * s.rank, 0);
+    bool rejected = false;
+    try {
+        createScheme(s);
+    } catch (const std::invalid_argument &) {
+        rejected = true;
+    }
+    if (!rejected) {
+        ++failures;
+        std::cout << "  BŁĄD createScheme przyjął schemat 10x1x10\n";
+    }
+}
+
+} // namespace
+
+int main() {
+    std::cout << "=== Mnożenie: backendy IMnozenie vs iloczyn naiwny ===" << std::endl;
+
+    // mały liść, żeby rekurencja miała kilka poziomów także dla małych kształtów
+    threadPoolSetSize(1);
+    testBackend("gemm", *createGemm(), kShapes);
+    testBackend("binet", *createBinet(16, 0), kShapes);
+    testBackend("strassen", *createStrassen(16, 0), kShapes);
+    testBackend("winograd", *createWinograd(16), kShapes);
+    testBackend("ai 4x5*5x5", *createAI(), {{4, 5, 5}});
+    for (const char *scheme : {"strassen", "laderman", "ai455"}) {
+        testBackend(std::string("schemat ") + scheme, *createScheme(builtinScheme(scheme), 8), kShapes);
+        testBackend(std::string("schemat ") + scheme + " (pad)",
+                    *createScheme(builtinScheme(scheme), 8, SchemeEdges::Pad), kShapes);
+    }
+    testBackend("auto", *createAuto("", 1), kShapes);
+
+    // wersje równoległe na wspólnej puli
+    threadPoolSetSize(4);
+    testBackend("binet (4 wątki)", *createBinet(16, parallelDepthFor(4, 4)), kShapes);
+    testBackend("strassen (4 wątki)", *createStrassen(16, parallelDepthFor(7, 4)), kShapes);
+    testBackend("auto (4 wątki)", *createAuto("", 4), kShapes);
+    threadPoolSetSize(1);
+
+    testBatched();
+    testSchemeLimits();
+
+    std::cout << (failures == 0 ? "Wszystkie testy przeszły" : "Nieudane testy: " + std::to_string(failures))
+              << std::endl;
+    return failures == 0 ? 0 : 1;
+}
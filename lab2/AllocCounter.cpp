@@ -0,0 +1,122 @@
+#include "SupportFunctions.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <sstream>
+
+#ifndef MATRIX_NO_INSTRUMENTATION
+
+// Globalne operator new/delete liczące faktyczne alokacje całego programu
+// (bufory Matrix, bloki aren, bufory pakowania gemm, kontenery biblioteki).
+// Przed każdym blokiem zapisywany jest jego rozmiar, żeby delete wiedziało,
+// ile bajtów zwalnia.
+
+namespace {
+
+constexpr std::size_t kHeader = alignof(std::max_align_t);
+
+std::atomic<std::uint64_t> g_live{0};
+std::atomic<std::uint64_t> g_peak{0};
+std::atomic<std::uint64_t> g_count{0};
+std::atomic<std::uint64_t> g_histogram[AllocStats::kBuckets];
+
+int bucketOf(std::size_t size) {
+    int k = 0;
+    while (k + 1 < AllocStats::kBuckets && (std::size_t(1) << (k + 1)) <= size) ++k;
+    return k;
+}
+
+void recordAlloc(std::size_t size) {
+    std::uint64_t live = g_live.fetch_add(size, std::memory_order_relaxed) + size;
+    std::uint64_t peak = g_peak.load(std::memory_order_relaxed);
+    while (peak < live && !g_peak.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {}
+    g_count.fetch_add(1, std::memory_order_relaxed);
+    g_histogram[bucketOf(size)].fetch_add(1, std::memory_order_relaxed);
+}
+
+void recordFree(std::size_t size) {
+    g_live.fetch_sub(size, std::memory_order_relaxed);
+}
+
+// [rozmiar | ... | dane], przesunięcie nagłówka = max(align, kHeader)
+void *trackedAlloc(std::size_t size, std::size_t align) {
+    std::size_t offset = align > kHeader ? align : kHeader;
+    void *raw = align > kHeader
+        ? std::aligned_alloc(align, (size + offset + align - 1) / align * align)
+        : std::malloc(size + offset);
+    if (!raw) return nullptr;
+    char *p = static_cast<char *>(raw) + offset;
+    reinterpret_cast<std::size_t *>(p)[-1] = size;
+    recordAlloc(size);
+    return p;
+}
+
+void trackedFree(void *ptr, std::size_t align) {
+    if (!ptr) return;
+    std::size_t offset = align > kHeader ? align : kHeader;
+    recordFree(reinterpret_cast<std::size_t *>(ptr)[-1]);
+    std::free(static_cast<char *>(ptr) - offset);
+}
+
+void *allocOrThrow(std::size_t size, std::size_t align) {
+    if (size == 0) size = 1;
+    while (true) {
+        if (void *p = trackedAlloc(size, align)) return p;
+        std::new_handler handler = std::get_new_handler();
+        if (!handler) throw std::bad_alloc();
+        handler();
+    }
+}
+
+} // namespace
+
+void *operator new(std::size_t size) { return allocOrThrow(size, kHeader); }
+void *operator new[](std::size_t size) { return allocOrThrow(size, kHeader); }
+void *operator new(std::size_t size, std::align_val_t al) { return allocOrThrow(size, static_cast<std::size_t>(al)); }
+void *operator new[](std::size_t size, std::align_val_t al) { return allocOrThrow(size, static_cast<std::size_t>(al)); }
+
+void *operator new(std::size_t size, const std::nothrow_t &) noexcept {
+    try { return allocOrThrow(size, kHeader); } catch (...) { return nullptr; }
+}
+void *operator new[](std::size_t size, const std::nothrow_t &) noexcept {
+    try { return allocOrThrow(size, kHeader); } catch (...) { return nullptr; }
+}
+
+void operator delete(void *ptr) noexcept { trackedFree(ptr, kHeader); }
+void operator delete[](void *ptr) noexcept { trackedFree(ptr, kHeader); }
+void operator delete(void *ptr, std::size_t) noexcept { trackedFree(ptr, kHeader); }
+void operator delete[](void *ptr, std::size_t) noexcept { trackedFree(ptr, kHeader); }
+void operator delete(void *ptr, const std::nothrow_t &) noexcept { trackedFree(ptr, kHeader); }
+void operator delete[](void *ptr, const std::nothrow_t &) noexcept { trackedFree(ptr, kHeader); }
+void operator delete(void *ptr, std::align_val_t al) noexcept { trackedFree(ptr, static_cast<std::size_t>(al)); }
+void operator delete[](void *ptr, std::align_val_t al) noexcept { trackedFree(ptr, static_cast<std::size_t>(al)); }
+void operator delete(void *ptr, std::size_t, std::align_val_t al) noexcept { trackedFree(ptr, static_cast<std::size_t>(al)); }
+void operator delete[](void *ptr, std::size_t, std::align_val_t al) noexcept { trackedFree(ptr, static_cast<std::size_t>(al)); }
+
+void allocCounterReset() {
+    g_peak = g_live.load();
+    g_count = 0;
+    for (auto &bucket : g_histogram) bucket = 0;
+}
+
+AllocStats allocCounterGet() {
+    AllocStats stats;
+    stats.live_bytes = g_live;
+    stats.peak_bytes = g_peak;
+    stats.alloc_count = g_count;
+    for (int k = 0; k < AllocStats::kBuckets; ++k) stats.histogram[k] = g_histogram[k];
+    return stats;
+}
+
+#endif // MATRIX_NO_INSTRUMENTATION
+
+std::string allocHistogramString(const AllocStats &stats) {
+    std::ostringstream out;
+    for (int k = 0; k < AllocStats::kBuckets; ++k) {
+        if (stats.histogram[k] == 0) continue;
+        if (out.tellp() > 0) out << ",";
+        out << k << ":" << stats.histogram[k];
+    }
+    return out.tellp() > 0 ? out.str() : "-";
+}
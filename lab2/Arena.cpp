@@ -0,0 +1,95 @@
+#include "Arena.h"
+#include "SupportFunctions.h"
+
+#include <algorithm>
+#include <cstdint>
+
+namespace {
+
+constexpr std::size_t kAlign = 8; // w elementach double, czyli 64 bajty
+constexpr std::size_t kDefaultChunk = std::size_t(1) << 16; // 512 KiB
+
+} // namespace
+
+Arena::Scope::Scope(Arena &arena)
+    : arena_(arena), chunk_(arena.current_),
+      offset_(arena.chunks_.empty() ? 0 : arena.chunks_[arena.current_].used),
+      used_(arena.used_) {}
+
+Arena::Scope::~Scope() {
+    arena_.release(chunk_, offset_, used_);
+}
+
+void Arena::release(std::size_t chunk, std::size_t offset, std::size_t used) {
+    for (std::size_t i = chunk + 1; i <= current_ && i < chunks_.size(); ++i) chunks_[i].used = 0;
+    if (chunk < chunks_.size()) chunks_[chunk].used = offset;
+    current_ = chunk;
+    memCounterArenaRelease((used_ - used) * sizeof(double));
+    used_ = used;
+}
+
+void Arena::reserve(std::size_t count) {
+    count = footprint(count);
+    if (!chunks_.empty() && chunks_[current_].size - chunks_[current_].used >= count) return;
+    for (std::size_t i = current_ + 1; i < chunks_.size(); ++i) {
+        if (chunks_[i].size >= count) return; // allocate przejdzie do tego bloku
+    }
+
+    Chunk chunk;
+    chunk.storage.reset(new double[count + kAlign]);
+    auto addr = reinterpret_cast<std::uintptr_t>(chunk.storage.get());
+    chunk.data = reinterpret_cast<double *>((addr + 63) & ~static_cast<std::uintptr_t>(63));
+    chunk.size = count;
+
+    if (used_ == 0) {
+        // arena pusta - jeden blok o żądanym rozmiarze zamiast dotychczasowych
+        chunks_.clear();
+        chunks_.push_back(std::move(chunk));
+        current_ = 0;
+        return;
+    }
+    // następny blok po bieżącym (puste bloki za nim są zastępowane)
+    chunks_.resize(current_ + 1);
+    chunks_.push_back(std::move(chunk));
+}
+
+double *Arena::allocate(std::size_t count) {
+    count = footprint(count);
+    if (chunks_.empty() || chunks_[current_].size - chunks_[current_].used < count) {
+        // bieżący blok pełny - pierwszy wystarczająco duży z pustych bloków
+        // za nim albo nowy, co najmniej dwa razy większy od poprzedniego
+        std::size_t next = current_ + 1;
+        while (next < chunks_.size() && chunks_[next].size < count) ++next;
+        if (next < chunks_.size()) {
+            current_ = next;
+        } else {
+            std::size_t grow = chunks_.empty() ? kDefaultChunk : 2 * chunks_.back().size;
+            reserve(std::max(count, grow));
+            if (chunks_[current_].size - chunks_[current_].used < count) ++current_;
+        }
+    }
+
+    Chunk &c = chunks_[current_];
+    double *p = c.data + c.used;
+    c.used += count;
+    used_ += count;
+    peak_ = std::max(peak_, used_);
+    memCounterArenaAlloc(count * sizeof(double));
+    return p;
+}
+
+MatrixView Arena::allocate(int rows, int cols) {
+    double *p = allocate(static_cast<std::size_t>(rows) * static_cast<std::size_t>(cols));
+    return MatrixView(p, rows, cols, cols);
+}
+
+std::size_t Arena::capacityBytes() const {
+    std::size_t total = 0;
+    for (const Chunk &c : chunks_) total += c.size;
+    return total * sizeof(double);
+}
+
+Arena &threadArena() {
+    thread_local Arena arena;
+    return arena;
+}
@@ -0,0 +1,206 @@
+#include "Auto.h"
+#include "Binet.h"
+#include "Gemm.h"
+#include "Strassen.h"
+#include "SupportFunctions.h"
+#include "ThreadPool.h"
+#include "Winograd.h"
+
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <functional>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+enum class Kind { Gemm, Binet, Strassen, Winograd };
+
+struct Candidate {
+    Kind kind;
+    int leafSize;
+    std::unique_ptr<IMnozenie> impl;
+};
+
+struct Entry {
+    int m, k, n;
+    int candidate;  // indeks w AutoImpl::candidates
+    double seconds;
+};
+
+const char *kindName(Kind kind) {
+    switch (kind) {
+        case Kind::Gemm: return "gemm";
+        case Kind::Binet: return "binet";
+        case Kind::Strassen: return "strassen";
+        case Kind::Winograd: return "winograd";
+    }
+    return "?";
+}
+
+// czy backend obsługuje (m x k) * (k x n)
+// (wszystkie backendy lab2 przyjmują dowolne kształty)
+bool supports(Kind, int, int, int) {
+    return true;
+}
+
+double bestTime(int repeats, const std::function<void()> &run) {
+    double best = 0.0;
+    for (int r = 0; r < repeats; ++r) {
+        auto t0 = std::chrono::steady_clock::now();
+        run();
+        auto t1 = std::chrono::steady_clock::now();
+        double t = std::chrono::duration<double>(t1 - t0).count();
+        if (r == 0 || t < best) best = t;
+    }
+    return best;
+}
+
+// Siatka strojenia: wszystkie kombinacje wymiarów z dims (małe, wąskie
+// i kwadratowe) plus większe kwadraty, gdzie liczy się Strassen/Winograd.
+std::vector<std::array<int, 3>> tuningShapes() {
+    const int dims[] = {4, 16, 64, 256};
+    std::vector<std::array<int, 3>> shapes;
+    for (int m : dims)
+        for (int k : dims)
+            for (int n : dims) shapes.push_back({m, k, n});
+    shapes.push_back({512, 512, 512});
+    return shapes;
+}
+
+class AutoImpl : public IMnozenie {
+public:
+    AutoImpl(const std::string &tablePath, int threads) {
+        int binetDepth = parallelDepthFor(4, threads);
+        int strassenDepth = parallelDepthFor(7, threads);
+        candidates.push_back({Kind::Gemm, 0, createGemm()});
+        for (int leaf : {32, 64, 128}) {
+            candidates.push_back({Kind::Binet, leaf, createBinet(leaf, binetDepth)});
+            candidates.push_back({Kind::Strassen, leaf, createStrassen(leaf, strassenDepth)});
+            candidates.push_back({Kind::Winograd, leaf, createWinograd(leaf)});
+        }
+
+        if (tablePath.empty() || !load(tablePath)) {
+            tune();
+            if (!tablePath.empty()) save(tablePath);
+        }
+    }
+
+    void multiplyInto(ConstMatrixView A, ConstMatrixView B, MatrixView C) override {
+        if (A.cols != B.rows) throw std::runtime_error("Incompatible dimensions for multiplication");
+        candidates[select(A.rows, A.cols, B.cols)].impl->multiplyInto(A, B, C);
+    }
+
+    void multiplyAdd(MatrixView C, double alpha, ConstMatrixView A, ConstMatrixView B, double beta,
+                     Op opA, Op opB) override {
+        int m = opRows(A, opA), k = opCols(A, opA), n = opCols(B, opB);
+        if (k != opRows(B, opB)) throw std::runtime_error("Incompatible dimensions for multiplication");
+        candidates[select(m, k, n)].impl->multiplyAdd(C, alpha, A, B, beta, opA, opB);
+    }
+
+private:
+    std::vector<Candidate> candidates;
+    std::vector<Entry> table;
+
+    // Najbliższy wpis tabeli (suma |log2| ilorazów wymiarów), którego
+    // zwycięzca obsługuje ten kształt; gdy żaden - gemm.
+    int select(int m, int k, int n) const {
+        int best = 0;
+        double bestDistance = 0.0;
+        bool found = false;
+        for (const Entry &e : table) {
+            if (!supports(candidates[e.candidate].kind, m, k, n)) continue;
+            double d = std::fabs(std::log2(double(m) / e.m)) + std::fabs(std::log2(double(k) / e.k)) +
+                       std::fabs(std::log2(double(n) / e.n));
+            if (!found || d < bestDistance) {
+                best = e.candidate;
+                bestDistance = d;
+                found = true;
+            }
+        }
+        return best;
+    }
+
+    void tune() {
+        table.clear();
+        for (const auto &shape : tuningShapes()) {
+            int m = shape[0], k = shape[1], n = shape[2];
+            Matrix A = createRandomMatrix(m, k);
+            Matrix B = createRandomMatrix(k, n);
+            Matrix C(m, n);
+
+            // małe problemy powtarzane w pętli, żeby czas był mierzalny
+            double flops = 2.0 * m * k * n;
+            int inner = flops < 1e6 ? static_cast<int>(1e6 / flops) : 1;
+
+            Entry entry{m, k, n, -1, 0.0};
+            for (std::size_t c = 0; c < candidates.size(); ++c) {
+                if (!supports(candidates[c].kind, m, k, n)) continue;
+                IMnozenie &impl = *candidates[c].impl;
+                impl.multiplyInto(A, B, C);  // rozgrzanie
+                double t = bestTime(3, [&] {
+                    for (int i = 0; i < inner; ++i) impl.multiplyInto(A, B, C);
+                }) / inner;
+                if (entry.candidate < 0 || t < entry.seconds) {
+                    entry.candidate = static_cast<int>(c);
+                    entry.seconds = t;
+                }
+            }
+            table.push_back(entry);
+        }
+    }
+
+    int findCandidate(const std::string &name, int leafSize) const {
+        for (std::size_t c = 0; c < candidates.size(); ++c) {
+            if (name == kindName(candidates[c].kind) && leafSize == candidates[c].leafSize) {
+                return static_cast<int>(c);
+            }
+        }
+        return -1;
+    }
+
+    // format: "m k n backend leafSize seconds", linie z # pomijane
+    bool load(const std::string &path) {
+        std::ifstream in(path);
+        if (!in.is_open()) return false;
+        std::vector<Entry> loaded;
+        std::string line;
+        while (std::getline(in, line)) {
+            if (line.empty() || line[0] == '#') continue;
+            std::istringstream iss(line);
+            Entry e;
+            std::string name;
+            int leafSize;
+            if (!(iss >> e.m >> e.k >> e.n >> name >> leafSize >> e.seconds)) return false;
+            e.candidate = findCandidate(name, leafSize);
+            if (e.candidate < 0 || e.m <= 0 || e.k <= 0 || e.n <= 0) return false;
+            loaded.push_back(e);
+        }
+        if (loaded.empty()) return false;
+        table = std::move(loaded);
+        return true;
+    }
+
+    // Błąd zapisu nie jest krytyczny - tabela zostaje w pamięci,
+    // przy następnym uruchomieniu strojenie zostanie powtórzone.
+    void save(const std::string &path) const {
+        std::ofstream out(path);
+        if (!out.is_open()) return;
+        out << "# m k n backend leaf_size seconds\n";
+        out.precision(6);
+        for (const Entry &e : table) {
+            const Candidate &c = candidates[e.candidate];
+            out << e.m << " " << e.k << " " << e.n << " " << kindName(c.kind) << " " << c.leafSize << " "
+                << std::scientific << e.seconds << std::defaultfloat << "\n";
+        }
+    }
+};
+
+} // namespace
+
+std::unique_ptr<IMnozenie> createAuto(const std::string &tablePath, int threads) {
+    return std::make_unique<AutoImpl>(tablePath, threads);
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+#include "Mnozenie.h"
+#include <memory>
+#include <string>
+
+/**
+ * Fabryka zwracająca implementację IMnozenie, która każde mnożenie kieruje
+ * do najszybszego na tej maszynie backendu dla danego kształtu (m, k, n).
+ *
+ * Kandydaci to gemm, Binet, Strassen i Winograd z kilkoma rozmiarami
+ * liścia. Tabela strojenia - najszybszy kandydat dla siatki
+ * kształtów: małych, prostokątnych i kwadratowych - jest wczytywana z pliku
+ * tablePath, a gdy go nie ma (albo jest niepoprawny), mierzona od nowa
+ * i zapisywana pod tą ścieżką. Pusta ścieżka oznacza strojenie bez zapisu.
+ * Mnożenie kształtu spoza siatki używa najbliższego (w skali logarytmicznej)
+ * kształtu, dla którego zwycięzca obsługuje dane wymiary.
+ *
+ * threads to rozmiar puli wątków, dla którego dobierana jest głębokość
+ * zrównoleglenia Binet/Strassena. Strojenie zmienia liczniki operacji
+ * i pamięci - tworzyć przed pomiarami.
+ */
+std::unique_ptr<IMnozenie> createAuto(const std::string &tablePath = "autotune.txt", int threads = 1);
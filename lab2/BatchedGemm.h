@@ -0,0 +1,42 @@
+#pragma once
+
+#include "Mnozenie.h"
+
+/**
+ * Wsadowe mnożenie wielu małych macierzy tego samego kształtu.
+ *
+ * Problemy pakowane są po kLanes (8) z przeplotem: element (i, j) kolejnych
+ * problemów leży obok siebie, więc jeden wektor SIMD liczy ten sam element
+ * ośmiu niezależnych iloczynów (jeden problem na pas). Kształty kwadratowe
+ * 1..kSmallGemmMax mają jądra o rozmiarze znanym w czasie kompilacji
+ * (pętle w pełni rozwinięte), pozostałe małe kształty - jądro z wymiarami
+ * w czasie wykonania. Wariant AVX2 / AVX-512 wybierany jest tak jak w Simd.h.
+ *
+ * Bez wywołań wirtualnych, alokacji i pakowania w stylu GotoBLAS - to
+ * właśnie ten stały narzut dominuje przy tysiącach mnożeń 1x1..16x16
+ * w liściach rekurencji.
+ */
+constexpr int kSmallGemmMax = 16;
+
+// czy (m x k) * (k x n) mieści się w jądrach wsadowych
+inline bool isSmallGemm(int m, int k, int n) {
+    return m <= kSmallGemmMax && k <= kSmallGemmMax && n <= kSmallGemmMax;
+}
+
+// C[i] = A[i] * B[i] dla i < count. Wszystkie problemy muszą mieć ten sam
+// kształt (inaczej std::runtime_error); C[i] nie może nachodzić na żadne A[j], B[j].
+// Kształty większe niż kSmallGemmMax liczone są po kolei blokowym gemm.
+void gemmBatched(int count, const ConstMatrixView *A, const ConstMatrixView *B, const MatrixView *C);
+
+// Jak gemmBatched, ale problemy większe niż kSmallGemmMax - i małe, dla których
+// niepełna grupa pasów nie jest szybsza (za mało problemów) - idą przez multImpl
+void multiplyBatch(IMnozenie &multImpl, int count, const ConstMatrixView *A, const ConstMatrixView *B,
+                   const MatrixView *C);
+
+// Pojedyncze C = A * B: małe jądrem wsadowym, większe przez multImpl
+void multiplySmall(IMnozenie &multImpl, ConstMatrixView A, ConstMatrixView B, MatrixView C);
+
+// C = alpha * A * B + beta * C w miejscu: małe bezpośrednio gemm (bez wywołania
+// wirtualnego), większe przez multImpl.multiplyAdd
+void multiplyAddSmall(IMnozenie &multImpl, MatrixView C, double alpha, ConstMatrixView A, ConstMatrixView B,
+                      double beta);
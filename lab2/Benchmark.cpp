@@ -0,0 +1,147 @@
+#include "Benchmark.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+BenchConfig parseBenchArgs(int argc, char **argv, std::vector<int> defaultSizes) {
+    BenchConfig config;
+    auto value = [&](int &i) -> std::string {
+        if (i + 1 >= argc) throw std::runtime_error(std::string("Missing value for ") + argv[i]);
+        return argv[++i];
+    };
+    auto number = [](const std::string &s) {
+        try {
+            return std::stoi(s);
+        } catch (...) {
+            throw std::runtime_error("Invalid number: " + s);
+        }
+    };
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--warmup") config.warmup = number(value(i));
+        else if (arg == "--reps") config.repetitions = number(value(i));
+        else if (arg == "--cpu") config.cpu = number(value(i));
+        else if (arg == "--threads") config.threads = number(value(i));
+        else if (arg == "--format") config.format = value(i);
+        else if (arg == "--out") config.output = value(i);
+        else config.sizes.push_back(number(arg));
+    }
+
+    if (config.warmup < 0 || config.repetitions < 1 || config.threads < 1) {
+        throw std::runtime_error("Invalid repetition or thread count");
+    }
+    if (config.format != "csv" && config.format != "json") {
+        throw std::runtime_error("Unknown format: " + config.format);
+    }
+    if (config.sizes.empty()) config.sizes = std::move(defaultSizes);
+    return config;
+}
+
+bool pinCurrentThread(int cpu) {
+#ifdef __linux__
+    if (cpu < 0) return false;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return sched_setaffinity(0, sizeof(set), &set) == 0;
+#else
+    (void)cpu;
+    return false;
+#endif
+}
+
+namespace {
+
+// percentyl metodą najbliższej rangi z posortowanej próbki
+double percentile(const std::vector<double> &sorted, double p) {
+    std::size_t rank = static_cast<std::size_t>(std::ceil(p * sorted.size()));
+    return sorted[std::min(sorted.size() - 1, rank > 0 ? rank - 1 : 0)];
+}
+
+} // namespace
+
+BenchResult runBenchmark(const std::string &name, int n, const BenchConfig &config,
+                         const std::function<void()> &run, double flops) {
+    for (int i = 0; i < config.warmup; ++i) run();
+
+    std::vector<double> times;
+    for (int i = 0; i < config.repetitions; ++i) {
+        auto t0 = std::chrono::steady_clock::now();
+        run();
+        auto t1 = std::chrono::steady_clock::now();
+        times.push_back(std::chrono::duration<double>(t1 - t0).count());
+    }
+    std::sort(times.begin(), times.end());
+
+    BenchResult r;
+    r.name = name;
+    r.n = n;
+    r.warmup = config.warmup;
+    r.repetitions = config.repetitions;
+    r.min = times.front();
+    std::size_t mid = times.size() / 2;
+    r.median = times.size() % 2 ? times[mid] : 0.5 * (times[mid - 1] + times[mid]);
+    r.p90 = percentile(times, 0.9);
+    for (double t : times) r.mean += t;
+    r.mean /= times.size();
+    for (double t : times) r.stddev += (t - r.mean) * (t - r.mean);
+    r.stddev = times.size() > 1 ? std::sqrt(r.stddev / (times.size() - 1)) : 0.0;
+    r.flops = flops;
+    r.gflops = flops > 0 && r.median > 0 ? flops / r.median * 1e-9 : 0.0;
+
+    std::cerr << name << " N=" << n << ": median " << std::fixed << std::setprecision(6) << r.median
+              << " s (min " << r.min << ", p90 " << r.p90 << ")";
+    if (r.gflops > 0) std::cerr << std::setprecision(2) << ", " << r.gflops << " GFLOP/s";
+    std::cerr << "\n";
+    return r;
+}
+
+void writeBenchResults(std::ostream &out, const std::vector<BenchResult> &results, const std::string &format) {
+    out << std::setprecision(9);
+    if (format == "json") {
+        out << "[\n";
+        for (std::size_t i = 0; i < results.size(); ++i) {
+            const BenchResult &r = results[i];
+            out << "  {\"name\": \"" << r.name << "\", \"n\": " << r.n
+                << ", \"warmup\": " << r.warmup << ", \"reps\": " << r.repetitions
+                << ", \"min_s\": " << r.min << ", \"median_s\": " << r.median
+                << ", \"p90_s\": " << r.p90 << ", \"mean_s\": " << r.mean
+                << ", \"stddev_s\": " << r.stddev << ", \"flops\": " << r.flops
+                << ", \"gflops\": ";
+            if (r.gflops > 0) out << r.gflops;
+            else out << "null";
+            out << "}" << (i + 1 < results.size() ? "," : "") << "\n";
+        }
+        out << "]\n";
+        return;
+    }
+
+    out << "name,n,warmup,reps,min_s,median_s,p90_s,mean_s,stddev_s,flops,gflops\n";
+    for (const BenchResult &r : results) {
+        out << r.name << "," << r.n << "," << r.warmup << "," << r.repetitions << ","
+            << r.min << "," << r.median << "," << r.p90 << "," << r.mean << ","
+            << r.stddev << "," << r.flops << ",";
+        if (r.gflops > 0) out << r.gflops;
+        out << "\n";
+    }
+}
+
+void writeBenchResults(const BenchConfig &config, const std::vector<BenchResult> &results) {
+    if (config.output.empty()) {
+        writeBenchResults(std::cout, results, config.format);
+        return;
+    }
+    std::ofstream out(config.output);
+    if (!out.is_open()) throw std::runtime_error("Can't create file: " + config.output);
+    writeBenchResults(out, results, config.format);
+}
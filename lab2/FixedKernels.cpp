@@ -0,0 +1,24 @@
+#include "FixedKernels.h"
+
+#include <array>
+
+namespace {
+
+using FixedFn = void (*)(ConstMatrixView A, ConstMatrixView B, MatrixView C, bool accumulate);
+
+// s = ((m - 1) * kFixedMax + (k - 1)) * kFixedMax + (n - 1)
+template <std::size_t... S>
+constexpr std::array<FixedFn, sizeof...(S)> classicalKernels(std::index_sequence<S...>) {
+    return {{&schemeMultiplyInto<ClassicalScheme<static_cast<int>(S) / (kFixedMax * kFixedMax) + 1,
+                                                 static_cast<int>(S) / kFixedMax % kFixedMax + 1,
+                                                 static_cast<int>(S) % kFixedMax + 1>>...}};
+}
+
+constexpr auto kClassicalKernels = classicalKernels(std::make_index_sequence<kFixedMax * kFixedMax * kFixedMax>());
+
+} // namespace
+
+void fixedMultiplyInto(ConstMatrixView A, ConstMatrixView B, MatrixView C, bool accumulate) {
+    int s = ((A.rows - 1) * kFixedMax + (A.cols - 1)) * kFixedMax + (B.cols - 1);
+    kClassicalKernels[s](A, B, C, accumulate);
+}
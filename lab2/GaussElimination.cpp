@@ -1,62 +1,92 @@
 #include "GaussElimination.h"
 #include "SupportFunctions.h"
 #include "LUfactorization.h"
-#include "Inverse.h"
+#include "Triangular.h"
+#include "Arena.h"
+#include "BatchedGemm.h"
 
-std::pair<Matrix, Matrix> GaussElimination(const Matrix &A, const Matrix &b, std::unique_ptr<IMnozenie> &multImpl) {
+#include <algorithm>
+
+std::size_t GaussEliminationScratchSize(int n) {
+    if (n == 1) return 0;
+    // L11 żyje w trakcie obu rozkładów, S1 i S - w trakcie rozkładu
+    // dopełnienia Schura (LS w buforze po L11); prawe strony to widoki
+    int h1 = (n + 1) / 2, h2 = n / 2;
+    return Arena::footprint(h1, h1)
+           + std::max(LUScratchSize(h1), Arena::footprint(h2, h1) + Arena::footprint(h2, h2) + LUScratchSize(h2));
+}
+
+void GaussEliminationInto(ConstMatrixView A, ConstMatrixView b, MatrixView C, MatrixView c, IMnozenie &multImpl) {
     if (rows(A) == 1) {
-        return {A, b};
+        copyInto(A, C);
+        copyInto(b, c);
+        return;
     }
 
-    if (rows(A) % 2 == 0) {
-        memCounterEnterCall(rows(A), cols(A), 4);
+    // podział ceil(n / 2) / floor(n / 2) na widokach - bez dopełniania nieparzystych n
+    int h1 = (rows(A) + 1) / 2, h2 = rows(A) / 2;
+    int nrhs = cols(b);
 
-        int halfSize = rows(A) / 2;
+    // L11 (potem LS), S1 i dopełnienie Schura S - co najwyżej h1 x h1 każdy
+    memCounterEnterCall(h1, h1, 3);
 
-        Matrix A11 = subMatrix(A, 0, 0, halfSize, halfSize);
-        Matrix A12 = subMatrix(A, 0, halfSize, halfSize, halfSize);
-        Matrix A21 = subMatrix(A, halfSize, 0, halfSize, halfSize);
-        Matrix A22 = subMatrix(A, halfSize, halfSize, halfSize, halfSize);
+    ConstMatrixView A11 = A.block(0, 0, h1, h1);
+    ConstMatrixView A12 = A.block(0, h1, h1, h2);
+    ConstMatrixView A21 = A.block(h1, 0, h2, h1);
+    ConstMatrixView A22 = A.block(h1, h1, h2, h2);
 
-        Matrix b1 = subMatrix(b, 0, 0, halfSize, 1);
-        Matrix b2 = subMatrix(b, halfSize, 0, halfSize, 1);
+    ConstMatrixView b1 = b.block(0, 0, h1, nrhs);
+    ConstMatrixView b2 = b.block(h1, 0, h2, nrhs);
 
-        auto [L11, U11] = LUfactorization(A11, multImpl);
+    MatrixView C11 = C.block(0, 0, h1, h1);
+    MatrixView C12 = C.block(0, h1, h1, h2);
+    MatrixView C21 = C.block(h1, 0, h2, h1);
+    MatrixView C22 = C.block(h1, h1, h2, h2);
 
-        Matrix L11_inv = inverse(L11, multImpl);
-        Matrix U11_inv = inverse(U11, multImpl);
+    MatrixView c1 = c.block(0, 0, h1, nrhs);
+    MatrixView c2 = c.block(h1, 0, h2, nrhs);
 
-        Matrix S1 = multImpl->multiply(A21, U11_inv);
-        Matrix S2 = multImpl->multiply(L11_inv, A12);
-        Matrix S3 = L11_inv * b1;
+    Arena &arena = threadArena();
+    Arena::Scope scope(arena);
 
-        auto [LS, US] = LUfactorization(A22 - multImpl->multiply(S1, S2), multImpl);
+    // U11 trafia od razu w miejsce C11
+    MatrixView L11 = arena.allocate(h1, h1);
+    LUfactorizationInto(A11, L11, C11, multImpl);
 
-        Matrix LS_inv = inverse(LS, multImpl);
+    // S1 = A21 * U11^-1, S2 = L11^-1 * A12 (od razu prawy górny blok wyniku)
+    // i S3 = L11^-1 * b1 = c1 - układy trójkątne rozwiązywane w miejscu (trsm,
+    // dla jednej prawej strony sprowadzane do trsv)
+    MatrixView S1 = arena.allocate(h2, h1);
+    copyInto(A21, S1);
+    trsm(Side::Right, Uplo::Upper, Diag::NonUnit, C11, S1, multImpl);
+    copyInto(A12, C12);
+    trsm(Side::Left, Uplo::Lower, Diag::Unit, L11, C12, multImpl);
+    copyInto(b1, c1);
+    trsm(Side::Left, Uplo::Lower, Diag::Unit, L11, c1, multImpl);
 
-        Matrix c1 = S3;
-        Matrix c2 = LS_inv * b2 - multImpl->multiply(LS_inv, S1) * S3;
+    // S = A22 - S1 * S2 w miejscu, US trafia w miejsce C22, LS w bufor po L11
+    MatrixView S = arena.allocate(h2, h2);
+    copyInto(A22, S);
+    multiplyAddSmall(multImpl, S, -1.0, S1, C12, 1.0);
+    MatrixView LS = L11.block(0, 0, h2, h2);
+    LUfactorizationInto(S, LS, C22, multImpl);
 
-        Matrix C11 = U11;
-        Matrix C12 = multImpl->multiply(L11, A12);
-        Matrix C21 = zeroMatrix(halfSize, halfSize);
-        Matrix C22 = US;
+    // c2 = LS^-1 * (b2 - S1 * S3)
+    copyInto(b2, c2);
+    multiplyAddSmall(multImpl, c2, -1.0, S1, c1, 1.0);
+    trsm(Side::Left, Uplo::Lower, Diag::Unit, LS, c2, multImpl);
 
-        Matrix C = combine(C11, C12, 
-                           C21, C22);
-        Matrix c = combine(c1, {}, 
-                           c2, {});
+    setZero(C21);
 
-        memCounterExitCall(rows(A), cols(A), 4);
-        return {C, c};
-    } else {
-        Matrix A_padded = pad(A, rows(A) + 1, rows(A) + 1);
-        Matrix b_padded = pad(b, rows(b) + 1, 1);
-        A_padded[rows(A)][rows(A)] = 1.0;
-        b_padded[rows(b)][0] = 0.0;
-        auto [C_padded, c_padded] = GaussElimination(A_padded, b_padded, multImpl);
-        Matrix C = trim(C_padded, rows(A), rows(A));
-        Matrix c = trim(c_padded, rows(b), 1);
-        return {C, c};
-    }
-}
\ No newline at end of file
+    memCounterExitCall(h1, h1, 3);
+}
+
+std::pair<Matrix, Matrix> GaussElimination(const Matrix &A, const Matrix &b, std::unique_ptr<IMnozenie> &multImpl) {
+    Matrix C = zeroMatrix(rows(A), rows(A));
+    Matrix c = zeroMatrix(rows(b), cols(b));
+    Arena &arena = threadArena();
+    Arena::Scope scope(arena);
+    arena.reserve(GaussEliminationScratchSize(rows(A)));
+    GaussEliminationInto(A, b, C, c, *multImpl);
+    return {C, c};
+}
@@ -1,5 +1,16 @@
 #pragma once
 
 #include "Mnozenie.h"
+#include <cstddef>
 
-std::pair<Matrix, Matrix> GaussElimination(const Matrix &A, const Matrix &b, std::unique_ptr<IMnozenie> &multImpl);
\ No newline at end of file
+// A x = b sprowadzone do układu trójkątnego C x = c; C i c zapisywane w miejscu.
+// b może mieć kilka kolumn (prawych stron), c ma wtedy tyle samo. Do wielu
+// układów z tą samą macierzą A - LUSolver (LUfactorization.h), bez ponownego
+// rozkładu dla każdego b.
+void GaussEliminationInto(ConstMatrixView A, ConstMatrixView b, MatrixView C, MatrixView c, IMnozenie &multImpl);
+
+// Elementy areny zajmowane przez bufory GaussEliminationInto dla macierzy n x n
+// (prawe strony nie zajmują areny)
+std::size_t GaussEliminationScratchSize(int n);
+
+std::pair<Matrix, Matrix> GaussElimination(const Matrix &A, const Matrix &b, std::unique_ptr<IMnozenie> &multImpl);
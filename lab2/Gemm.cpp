@@ -0,0 +1,204 @@
+#include "Gemm.h"
+#include "SupportFunctions.h"
+#include "Simd.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+#include <unistd.h>
+
+namespace {
+
+long cacheSize(int name, long fallback) {
+    long size = sysconf(name);
+    return size > 0 ? size : fallback;
+}
+
+int roundDown(int x, int multiple, int lo, int hi) {
+    x = std::clamp(x, lo, hi);
+    return std::max(multiple, x / multiple * multiple);
+}
+
+// Panel B (kc x NR) ma zajmować połowę L1, blok A (mc x kc) połowę L2,
+// a spakowane B (kc x nc) połowę L3 - reszta zostaje na C i prefetch.
+GemmBlocking defaultBlocking(int MR, int NR) {
+    long l1 = 32 * 1024, l2 = 256 * 1024, l3 = 8 * 1024 * 1024;
+#ifdef _SC_LEVEL1_DCACHE_SIZE
+    l1 = cacheSize(_SC_LEVEL1_DCACHE_SIZE, l1);
+    l2 = cacheSize(_SC_LEVEL2_CACHE_SIZE, l2);
+    l3 = cacheSize(_SC_LEVEL3_CACHE_SIZE, l3);
+#endif
+    GemmBlocking b;
+    b.kc = roundDown(static_cast<int>(l1 / 2 / (NR * sizeof(double))), 8, 64, 512);
+    b.mc = roundDown(static_cast<int>(l2 / 2 / (b.kc * sizeof(double))), MR, MR, 512);
+    b.nc = roundDown(static_cast<int>(l3 / 2 / (b.kc * sizeof(double))), NR, NR, 4096);
+    return b;
+}
+
+// rozmiar kafla MR x NR zależy od mikrojądra wybranego w Simd.cpp; stałe po
+// pierwszym użyciu, więc wątki puli czytają je bez synchronizacji
+const GemmBlocking &blocking() {
+    static const GemmBlocking b = defaultBlocking(simdGemmKernel().MR, simdGemmKernel().NR);
+    return b;
+}
+
+// Ap[p * MR + i] = alpha * op(A)[i][p]; wiersze poza blokiem wypełniane zerami
+void packA(ConstMatrixView A, Op op, double alpha, double *Ap, int MR) {
+    int rows = opRows(A, op), cols = opCols(A, op);
+    for (int ir = 0; ir < rows; ir += MR) {
+        int mr = std::min(MR, rows - ir);
+        for (int p = 0; p < cols; ++p) {
+            if (op == Op::Trans) {
+                const double *Arow = A[p] + ir;
+                for (int i = 0; i < mr; ++i) Ap[i] = alpha * Arow[i];
+            } else {
+                for (int i = 0; i < mr; ++i) Ap[i] = alpha * A[ir + i][p];
+            }
+            for (int i = mr; i < MR; ++i) Ap[i] = 0.0;
+            Ap += MR;
+        }
+    }
+}
+
+// Bp[p * NR + j] = op(B)[p][j]; kolumny poza blokiem wypełniane zerami
+void packB(ConstMatrixView B, Op op, double *Bp, int NR) {
+    int rows = opRows(B, op), cols = opCols(B, op);
+    for (int jr = 0; jr < cols; jr += NR) {
+        int nr = std::min(NR, cols - jr);
+        for (int p = 0; p < rows; ++p) {
+            if (op == Op::Trans) {
+                for (int j = 0; j < nr; ++j) Bp[j] = B[jr + j][p];
+            } else {
+                const double *Bpj = B[p] + jr;
+                for (int j = 0; j < nr; ++j) Bp[j] = Bpj[j];
+            }
+            for (int j = nr; j < NR; ++j) Bp[j] = 0.0;
+            Bp += NR;
+        }
+    }
+}
+
+// m == 1, k == 1 albo n == 1 (bez transpozycji) - pakowanie się nie opłaca:
+// wiersze C liczone jako kombinacje wierszy B (axpy), a dla n == 1 jako
+// iloczyny skalarne z kolumną B skopiowaną do ciągłego bufora. alpha spoza
+// {1, -1} kosztuje mnożenie na element C (iloczyny skalarne) albo A (axpy).
+void gemmThin(ConstMatrixView A, ConstMatrixView B, MatrixView C, double alpha, bool accumulate) {
+    std::uint64_t scaled = 0;
+    if (B.cols == 1 && A.cols > 1) {
+        thread_local std::vector<double> x;
+        x.resize(A.cols);
+        for (int p = 0; p < A.cols; ++p) x[p] = B[p][0];
+        for (int i = 0; i < A.rows; ++i) {
+            double s = simdDot(A.cols, A[i], x.data());
+            if (alpha != 1.0) s *= alpha;
+            C[i][0] = accumulate ? C[i][0] + s : s;
+        }
+        scaled = A.rows;
+    } else {
+        for (int i = 0; i < A.rows; ++i) {
+            double *Ci = C[i];
+            if (!accumulate) std::fill(Ci, Ci + B.cols, 0.0);
+            for (int p = 0; p < A.cols; ++p)
+                simdAxpy(B.cols, alpha * A[i][p], B[p], Ci);
+        }
+        scaled = static_cast<std::uint64_t>(A.rows) * A.cols;
+    }
+    if (alpha != 1.0 && alpha != -1.0) opCounterAdd({0, 0, scaled, 0});
+}
+
+} // namespace
+
+GemmBlocking gemmBlocking() {
+    return blocking();
+}
+
+void gemm(ConstMatrixView A, ConstMatrixView B, MatrixView C, bool accumulate) {
+    gemm(C, 1.0, A, B, accumulate ? 1.0 : 0.0);
+}
+
+void gemm(MatrixView C, double alpha, ConstMatrixView A, ConstMatrixView B, double beta, Op opA, Op opB) {
+    int m = opRows(A, opA);
+    int k = opCols(A, opA);
+    int n = opCols(B, opB);
+    if (m == 0 || n == 0) return;
+    // beta spoza {0, 1} - C skalowane raz, dalej zwykła akumulacja
+    bool accumulate = beta != 0.0;
+    if (accumulate) scaleAssign(C, beta);
+    if (k == 0 || alpha == 0.0) {
+        if (!accumulate) setZero(C);
+        return;
+    }
+
+    // alpha = -1: każdy iloczyn odejmowany (także pierwszy, gdy C jest nadpisywane)
+    std::uint64_t mn = static_cast<std::uint64_t>(m) * n;
+    if (alpha == -1.0) opCounterAdd({0, mn * k, mn * k, 0});
+    else opCounterAdd({accumulate ? mn * k : mn * (k - 1), 0, mn * k, 0});
+
+    if ((m == 1 || k == 1 || n == 1) && opA == Op::NoTrans && opB == Op::NoTrans) {
+        gemmThin(A, B, C, alpha, accumulate);
+        return;
+    }
+
+    const SimdGemmKernel &kernel = simdGemmKernel();
+    const int MR = kernel.MR;
+    const int NR = kernel.NR;
+    const GemmBlocking bl = blocking();
+    int mcMax = std::min(bl.mc, (m + MR - 1) / MR * MR);
+    int kcMax = std::min(bl.kc, k);
+    int ncMax = std::min(bl.nc, (n + NR - 1) / NR * NR);
+
+    // alpha wchodzi do spakowanego A - jedno mnożenie na element A na panel nc
+    if (alpha != 1.0 && alpha != -1.0) {
+        std::uint64_t panels = (n + bl.nc - 1) / bl.nc;
+        opCounterAdd({0, 0, static_cast<std::uint64_t>(m) * k * panels, 0});
+    }
+
+    // bufory pakowania żyją między wywołaniami (po jednym komplecie na wątek)
+    thread_local std::vector<double> Abuf, Bbuf;
+    if (Abuf.size() < static_cast<std::size_t>(mcMax) * kcMax) Abuf.resize(static_cast<std::size_t>(mcMax) * kcMax);
+    if (Bbuf.size() < static_cast<std::size_t>(kcMax) * ncMax) Bbuf.resize(static_cast<std::size_t>(kcMax) * ncMax);
+    memCounterEnterCall(static_cast<std::size_t>(kcMax), static_cast<std::size_t>(mcMax + ncMax), 1);
+
+    for (int jc = 0; jc < n; jc += bl.nc) {
+        int nc = std::min(bl.nc, n - jc);
+        for (int pc = 0; pc < k; pc += bl.kc) {
+            int kc = std::min(bl.kc, k - pc);
+            bool acc = accumulate || pc > 0;
+            packB(opBlock(B, opB, pc, jc, kc, nc), opB, Bbuf.data(), NR);
+
+            for (int ic = 0; ic < m; ic += bl.mc) {
+                int mc = std::min(bl.mc, m - ic);
+                packA(opBlock(A, opA, ic, pc, mc, kc), opA, alpha, Abuf.data(), MR);
+
+                for (int jr = 0; jr < nc; jr += NR) {
+                    int nr = std::min(NR, nc - jr);
+                    const double *Bp = Bbuf.data() + static_cast<std::size_t>(jr) * kc;
+                    for (int ir = 0; ir < mc; ir += MR) {
+                        int mr = std::min(MR, mc - ir);
+                        const double *Ap = Abuf.data() + static_cast<std::size_t>(ir) * kc;
+                        kernel.run(kc, Ap, Bp, C[ic + ir] + jc + jr, C.ld, mr, nr, acc);
+                    }
+                }
+            }
+        }
+    }
+
+    memCounterExitCall(static_cast<std::size_t>(kcMax), static_cast<std::size_t>(mcMax + ncMax), 1);
+}
+
+class GemmImpl : public IMnozenie {
+public:
+    void multiplyInto(ConstMatrixView A, ConstMatrixView B, MatrixView C) override {
+        gemm(A, B, C);
+    }
+
+    void multiplyAdd(MatrixView C, double alpha, ConstMatrixView A, ConstMatrixView B, double beta,
+                     Op opA, Op opB) override {
+        if (opCols(A, opA) != opRows(B, opB)) throw std::runtime_error("Incompatible dimensions for multiplication");
+        gemm(C, alpha, A, B, beta, opA, opB);
+    }
+};
+
+std::unique_ptr<IMnozenie> createGemm() {
+    return std::make_unique<GemmImpl>();
+}
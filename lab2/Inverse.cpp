@@ -1,42 +1,86 @@
 #include "Inverse.h"
 #include "SupportFunctions.h"
+#include "Arena.h"
+#include "BatchedGemm.h"
+#include "LUfactorization.h"
 
-Matrix inverse(const Matrix &A, std::unique_ptr<IMnozenie> &multImpl) {
+std::size_t inverseScratchSize(int n) {
+    if (n == 1) return 0;
+    // T1 i T2 żyją w trakcie obu rekurencyjnych odwrotności (S leży w B12);
+    // większa połowa ma ceil(n / 2) wierszy
+    int h1 = (n + 1) / 2, h2 = n / 2;
+    return 2 * Arena::footprint(h1, h2) + inverseScratchSize(h1);
+}
+
+void inverseInto(ConstMatrixView A, MatrixView invA, IMnozenie &multImpl) {
     if (rows(A) == 1) {
-        Matrix invA = zeroMatrix(1, 1);
         invA[0][0] = 1.0 / A[0][0];
         opCounterAdd({0, 0, 0, 1});
-        return invA;
+        return;
     }
 
-    if (rows(A) % 2 == 0) {
+    // nieparzyste n dzielone nierówno, ceil(n / 2) i floor(n / 2) - same widoki,
+    // bez dopełniania do parzystego rozmiaru i kopiowania
+    int h1 = (rows(A) + 1) / 2, h2 = rows(A) / 2;
 
-        memCounterEnterCall(rows(A), cols(A), 3);
+    // T1 i T2 to jedyne bufory tymczasowe - dopełnienie Schura S liczone
+    // jest w miejscu, w bloku B12 (nadpisywanym dopiero na końcu)
+    memCounterEnterCall(h1, h2, 2);
 
-        int halfSize = rows(A) / 2;
-        Matrix invA11 = inverse(subMatrix(A, 0, 0, halfSize, halfSize), multImpl);
-        Matrix A12 = subMatrix(A, 0, halfSize, halfSize, halfSize);
-        Matrix A21 = subMatrix(A, halfSize, 0, halfSize, halfSize);
-        Matrix A22 = subMatrix(A, halfSize, halfSize, halfSize, halfSize);
+    ConstMatrixView A11 = A.block(0, 0, h1, h1);
+    ConstMatrixView A12 = A.block(0, h1, h1, h2);
+    ConstMatrixView A21 = A.block(h1, 0, h2, h1);
+    ConstMatrixView A22 = A.block(h1, h1, h2, h2);
 
-        Matrix T1 = multImpl->multiply(invA11, A12);
-        Matrix T2 = multImpl->multiply(A21, invA11);
-        
-        Matrix invS22 = inverse(A22 - multImpl->multiply(A21, T1), multImpl);
+    MatrixView B11 = invA.block(0, 0, h1, h1);
+    MatrixView B12 = invA.block(0, h1, h1, h2);
+    MatrixView B21 = invA.block(h1, 0, h2, h1);
+    MatrixView B22 = invA.block(h1, h1, h2, h2);
 
-        Matrix T3 = multImpl->multiply(T1, invS22);
+    Arena &arena = threadArena();
+    Arena::Scope scope(arena);
+    MatrixView T1 = arena.allocate(h1, h2), T2 = arena.allocate(h2, h1);
 
-        Matrix B11 = invA11 + multImpl->multiply(T3, T2);
-        Matrix B12 = negate(T3);
-        Matrix B21 = negate(multImpl->multiply(invS22, T2));
-        Matrix B22 = invS22;
+    // invA11 trafia od razu w miejsce B11 (B11 = invA11 + T3 * T2)
+    inverseInto(A11, B11, multImpl);
 
-        memCounterExitCall(rows(A), cols(A), 3);
-        return combine(B11, B12, B21, B22);
+    // T1 = invA11 * A12 i T2 = A21 * invA11 są niezależne - jedno wywołanie
+    // wsadowe (małe bloki bez wywołania wirtualnego, BatchedGemm.h); przy
+    // nierównym podziale mają różne kształty, więc idą osobno
+    if (h1 == h2) {
+        ConstMatrixView lhs[] = {B11, A21}, rhs[] = {A12, B11};
+        MatrixView out[] = {T1, T2};
+        multiplyBatch(multImpl, 2, lhs, rhs, out);
     } else {
-        Matrix A_padded = pad(A, rows(A) + 1, cols(A) + 1);
-        A_padded[rows(A)][cols(A)] = 1.0;
-        Matrix inv_padded = inverse(A_padded, multImpl);
-        return trim(inv_padded, rows(A), cols(A));
+        multiplySmall(multImpl, B11, A12, T1);
+        multiplySmall(multImpl, A21, B11, T2);
     }
-}
\ No newline at end of file
+
+    // S = A22 - A21 * T1 w miejscu (h2 x h2 na początku B12), invS22 zapisywane w miejsce B22
+    MatrixView S = B12.block(0, 0, h2, h2);
+    copyInto(A22, S);
+    multiplyAddSmall(multImpl, S, -1.0, A21, T1, 1.0);
+    inverseInto(S, B22, multImpl);
+
+    // B12 = -T3 = -T1 * invS22 i B21 = -invS22 * T2 - znak wchodzi w alpha
+    multiplyAddSmall(multImpl, B12, -1.0, T1, B22, 0.0);
+    multiplyAddSmall(multImpl, B21, -1.0, B22, T2, 0.0);
+
+    // B11 = invA11 + T3 * T2 = invA11 - B12 * T2, akumulowane w miejscu
+    multiplyAddSmall(multImpl, B11, -1.0, B12, T2, 1.0);
+
+    memCounterExitCall(h1, h2, 2);
+}
+
+Matrix inverse(const Matrix &A, std::unique_ptr<IMnozenie> &multImpl) {
+    Matrix invA = zeroMatrix(rows(A), cols(A));
+    Arena &arena = threadArena();
+    Arena::Scope scope(arena);
+    arena.reserve(inverseScratchSize(rows(A)));
+    inverseInto(A, invA, *multImpl);
+    return invA;
+}
+
+Matrix inversePivoted(const Matrix &A, std::unique_ptr<IMnozenie> &multImpl) {
+    return LUSolver(A, multImpl).solve(identityMatrix(rows(A)));
+}
@@ -1,5 +1,18 @@
 #pragma once
 
 #include "Mnozenie.h"
+#include <cstddef>
 
-Matrix inverse(const Matrix &A, std::unique_ptr<IMnozenie> &multImpl);
\ No newline at end of file
+// wynik zapisywany w miejscu do widoku invA (rows(A) x cols(A))
+void inverseInto(ConstMatrixView A, MatrixView invA, IMnozenie &multImpl);
+
+// Elementy areny (Arena.h) zajmowane przez bufory inverseInto dla macierzy n x n,
+// bez buforów samego mnożenia (te rezerwuje implementacja IMnozenie)
+std::size_t inverseScratchSize(int n);
+
+Matrix inverse(const Matrix &A, std::unique_ptr<IMnozenie> &multImpl);
+
+// A^-1 = U^-1 L^-1 P z rozkładu z wyborem elementu głównego - LUSolver
+// (LUfactorization.h) z macierzą jednostkową jako prawymi stronami.
+// Nie wymaga niezerowych wiodących minorów; macierz osobliwa - std::runtime_error.
+Matrix inversePivoted(const Matrix &A, std::unique_ptr<IMnozenie> &multImpl);
@@ -1,57 +1,209 @@
 #include "LUfactorization.h"
 #include "SupportFunctions.h"
-#include "Inverse.h"
+#include "Triangular.h"
+#include "Arena.h"
+#include "BatchedGemm.h"
+#include "Gemm.h"
 
-std::pair<Matrix, Matrix> LUfactorization(const Matrix &A, std::unique_ptr<IMnozenie> &multImpl) {
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace {
+
+// Szerokość panelu rozkładu blokowego - panel rozkładany jest rekurencyjnie
+// (gemm w środku), reszta macierzy aktualizowana raz na panel przez multImpl
+constexpr int kPanelWidth = 128;
+
+} // namespace
+
+// Zamiany wierszy i <-> piv[i] dla i z [k1, k2) w widoku A (jak laswp)
+void applyRowSwaps(MatrixView A, const int *piv, int k1, int k2) {
+    for (int i = k1; i < k2; ++i)
+        if (piv[i] != i) std::swap_ranges(A[i], A[i] + A.cols, A[piv[i]]);
+}
+
+// Rekurencyjny rozkład panelu m x n (m >= n), jak getrf2 w LAPACK: lewa połowa
+// kolumn, jej zamiany w prawej połowie, U12 = L11^-1 A12, A22 -= L21 U12,
+// prawa połowa (wiersze od h), jej zamiany w lewej połowie. piv względem
+// wierszy panelu.
+void LUpanelFactorization(MatrixView A, int *piv, IMnozenie &multImpl) {
+    int m = A.rows, n = A.cols;
+    if (n == 1) {
+        int p = 0;
+        for (int i = 1; i < m; ++i)
+            if (std::fabs(A[i][0]) > std::fabs(A[p][0])) p = i;
+        if (A[p][0] == 0.0) throw SingularMatrixError();
+        piv[0] = p;
+        std::swap(A[0][0], A[p][0]);
+        double r = 1.0 / A[0][0];
+        for (int i = 1; i < m; ++i) A[i][0] *= r;
+        opCounterAdd({0, 0, static_cast<std::uint64_t>(m - 1), 1});
+        return;
+    }
+
+    int h = n / 2;
+    MatrixView left = A.block(0, 0, m, h), right = A.block(0, h, m, n - h);
+    LUpanelFactorization(left, piv, multImpl);
+    applyRowSwaps(right, piv, 0, h);
+    MatrixView U12 = right.block(0, 0, h, n - h);
+    trsm(Side::Left, Uplo::Lower, Diag::Unit, left.block(0, 0, h, h), U12, multImpl);
+    gemm(right.block(h, 0, m - h, n - h), -1.0, left.block(h, 0, m - h, h), U12, 1.0);
+    LUpanelFactorization(right.block(h, 0, m - h, n - h), piv + h, multImpl);
+    for (int i = h; i < n; ++i) piv[i] += h;
+    applyRowSwaps(left, piv, h, n);
+}
+
+std::size_t LUScratchSize(int n) {
+    if (n == 1) return 0;
+    // dopełnienie Schura (floor(n / 2) x floor(n / 2)) żyje w trakcie drugiego rozkładu
+    int h1 = (n + 1) / 2, h2 = n / 2;
+    return std::max(LUScratchSize(h1), Arena::footprint(h2, h2) + LUScratchSize(h2));
+}
+
+void LUfactorizationInto(ConstMatrixView A, MatrixView L, MatrixView U, IMnozenie &multImpl) {
     if (rows(A) == 1) {
-        Matrix L = identityMatrix(1);
-        Matrix U = A;
-        return {L, U};
+        L[0][0] = 1.0;
+        U[0][0] = A[0][0];
+        return;
     }
     
-    if (rows(A) % 2 == 0) {
-        memCounterEnterCall(rows(A), cols(A), 3);
+    // podział ceil(n / 2) / floor(n / 2) na widokach - bez dopełniania nieparzystych n
+    int h1 = (rows(A) + 1) / 2, h2 = rows(A) / 2;
 
-        int halfSize = rows(A) / 2;
+    // jedynym buforem jest dopełnienie Schura - ćwiartki L i U to widoki
+    memCounterEnterCall(h2, h2, 1);
 
-        Matrix A11 = subMatrix(A, 0, 0, halfSize, halfSize);
-        Matrix A12 = subMatrix(A, 0, halfSize, halfSize, halfSize);
-        Matrix A21 = subMatrix(A, halfSize, 0, halfSize, halfSize);
-        Matrix A22 = subMatrix(A, halfSize, halfSize, halfSize, halfSize);
+    ConstMatrixView A11 = A.block(0, 0, h1, h1);
+    ConstMatrixView A12 = A.block(0, h1, h1, h2);
+    ConstMatrixView A21 = A.block(h1, 0, h2, h1);
+    ConstMatrixView A22 = A.block(h1, h1, h2, h2);
 
-        auto [L11, U11] = LUfactorization(A11, multImpl);
+    MatrixView L11 = L.block(0, 0, h1, h1);
+    MatrixView L12 = L.block(0, h1, h1, h2);
+    MatrixView L21 = L.block(h1, 0, h2, h1);
+    MatrixView L22 = L.block(h1, h1, h2, h2);
+    MatrixView U11 = U.block(0, 0, h1, h1);
+    MatrixView U12 = U.block(0, h1, h1, h2);
+    MatrixView U21 = U.block(h1, 0, h2, h1);
+    MatrixView U22 = U.block(h1, h1, h2, h2);
 
-        Matrix L11_inv = inverse(L11, multImpl);
-        Matrix U11_inv = inverse(U11, multImpl);
+    LUfactorizationInto(A11, L11, U11, multImpl);
 
-        Matrix U12 = multImpl->multiply(L11_inv, A12);
-        Matrix L21 = multImpl->multiply(A21, U11_inv);
+    // U12 = L11^-1 * A12 i L21 = A21 * U11^-1 rozwiązaniem układów trójkątnych
+    // w miejscu, bez odwracania L11 i U11
+    copyInto(A12, U12);
+    trsm(Side::Left, Uplo::Lower, Diag::Unit, L11, U12, multImpl);
+    copyInto(A21, L21);
+    trsm(Side::Right, Uplo::Upper, Diag::NonUnit, U11, L21, multImpl);
 
-        Matrix S = A22 - multImpl->multiply(L21, U12);
+    // S = A22 - L21 * U12 w miejscu, bez bufora na iloczyn
+    Arena &arena = threadArena();
+    Arena::Scope scope(arena);
+    MatrixView S = arena.allocate(h2, h2);
+    copyInto(A22, S);
+    multiplyAddSmall(multImpl, S, -1.0, L21, U12, 1.0);
 
-        auto [L22, U22] = LUfactorization(S, multImpl);
+    LUfactorizationInto(S, L22, U22, multImpl);
 
-        Matrix L = combine(L11, zeroMatrix(halfSize, halfSize),
-                           L21, L22);
-        Matrix U = combine(U11, U12,
-                           zeroMatrix(halfSize, halfSize), U22);
+    setZero(L12);
+    setZero(U21);
 
-        memCounterExitCall(rows(A), cols(A), 3);
-        return {L, U};
-    } else {
-        Matrix A_padded = pad(A, rows(A) + 1, rows(A) + 1);
-        auto [L_padded, U_padded] = LUfactorization(A_padded, multImpl);
-        Matrix L = trim(L_padded, rows(A), rows(A));
-        Matrix U = trim(U_padded, rows(A), rows(A));
-        return {L, U};
-    }
+    memCounterExitCall(h2, h2, 1);
+}
+
+std::pair<Matrix, Matrix> LUfactorization(const Matrix &A, std::unique_ptr<IMnozenie> &multImpl) {
+    Matrix L = zeroMatrix(rows(A), rows(A));
+    Matrix U = zeroMatrix(rows(A), rows(A));
+    Arena &arena = threadArena();
+    Arena::Scope scope(arena);
+    arena.reserve(LUScratchSize(rows(A)));
+    LUfactorizationInto(A, L, U, *multImpl);
+    return {L, U};
 }
 
 double determinantLU(const Matrix &A, std::unique_ptr<IMnozenie> &multImpl) {
-    auto [_, U] = LUfactorization(A, multImpl);
+    try {
+        return LUSolver(A, multImpl).determinant();
+    } catch (const SingularMatrixError &) {
+        return 0.0;
+    }
+}
+
+void LUfactorizationInPlace(MatrixView A, int *piv, IMnozenie &multImpl) {
+    int n = A.rows;
+    if (A.cols != n) throw std::runtime_error("LU factorization: matrix must be square");
+
+    // rozkład w miejscu - tylko wywołania, bez buforów
+    memCounterEnterCall(static_cast<std::size_t>(n), static_cast<std::size_t>(n), 0);
+
+    for (int j = 0; j < n; j += kPanelWidth) {
+        int nb = std::min(kPanelWidth, n - j), rest = n - j - nb;
+        LUpanelFactorization(A.block(j, j, n - j, nb), piv + j, multImpl);
+        for (int i = j; i < j + nb; ++i) piv[i] += j;
+
+        // zamiany wierszy panelu w kolumnach na lewo i na prawo od niego
+        applyRowSwaps(A.block(0, 0, n, j), piv, j, j + nb);
+        applyRowSwaps(A.block(0, j + nb, n, rest), piv, j, j + nb);
+        if (rest == 0) break;
+
+        // U12 = L11^-1 A12, potem A22 -= L21 U12 w miejscu
+        MatrixView U12 = A.block(j, j + nb, nb, rest);
+        trsm(Side::Left, Uplo::Lower, Diag::Unit, A.block(j, j, nb, nb), U12, multImpl);
+        multImpl.multiplyAdd(A.block(j + nb, j + nb, rest, rest), -1.0, A.block(j + nb, j, rest, nb), U12, 1.0);
+    }
+
+    memCounterExitCall(static_cast<std::size_t>(n), static_cast<std::size_t>(n), 0);
+}
+
+std::pair<Matrix, std::vector<int>> LUfactorizationPivoted(const Matrix &A, std::unique_ptr<IMnozenie> &multImpl) {
+    Matrix LU = A;
+    std::vector<int> piv(rows(A));
+    LUfactorizationInPlace(LU, piv.data(), *multImpl);
+    return {std::move(LU), std::move(piv)};
+}
+
+std::pair<Matrix, Matrix> unpackLU(ConstMatrixView LU) {
+    int n = rows(LU);
+    Matrix L = zeroMatrix(n, n);
+    Matrix U = zeroMatrix(n, n);
+    for (int i = 0; i < n; ++i) {
+        for (int j = 0; j < i; ++j) L[i][j] = LU[i][j];
+        L[i][i] = 1.0;
+        for (int j = i; j < n; ++j) U[i][j] = LU[i][j];
+    }
+    return {L, U};
+}
+
+Matrix permuteRows(const Matrix &A, const std::vector<int> &piv) {
+    Matrix PA = A;
+    applyRowSwaps(PA, piv.data(), 0, static_cast<int>(piv.size()));
+    return PA;
+}
+
+LUSolver::LUSolver(const Matrix &A, std::unique_ptr<IMnozenie> &multImpl)
+    : LU_(A), piv_(rows(A)), multImpl_(*multImpl) {
+    LUfactorizationInPlace(LU_, piv_.data(), multImpl_);
+}
+
+Matrix LUSolver::solve(const Matrix &B) const {
+    Matrix X = B;
+    solveInto(X);
+    return X;
+}
+
+void LUSolver::solveInto(MatrixView B) const {
+    if (B.rows != size()) throw std::runtime_error("Incompatible dimensions for LU solve");
+    // L U X = P B: zamiany wierszy, potem L^-1 i U^-1 dla wszystkich kolumn naraz
+    applyRowSwaps(B, piv_.data(), 0, size());
+    trsm(Side::Left, Uplo::Lower, Diag::Unit, LU_, B, multImpl_);
+    trsm(Side::Left, Uplo::Upper, Diag::NonUnit, LU_, B, multImpl_);
+}
+
+double LUSolver::determinant() const {
     double det = 1.0;
-    for (int i = 0; i < rows(U); ++i) {
-        det *= U[i][i];
+    for (int i = 0; i < size(); ++i) {
+        det *= piv_[i] == i ? LU_[i][i] : -LU_[i][i];
     }
     return det;
-}
\ No newline at end of file
+}
@@ -1,7 +1,91 @@
 #pragma once
 
 #include "Mnozenie.h"
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+// Zerowy element główny w rozkładzie z wyborem (macierz osobliwa); pozostałe
+// błędy (np. wymiary) to zwykły std::runtime_error
+struct SingularMatrixError : std::runtime_error {
+    SingularMatrixError() : std::runtime_error("LU factorization: matrix is singular") {}
+};
+
+// A = L * U, czynniki zapisywane w miejscu do widoków L i U (rows(A) x rows(A)).
+// Rekurencja po połowach (U12 i L21 z układów trójkątnych, Triangular.h),
+// bez wyboru elementu głównego - wymaga
+// niezerowych wiodących minorów (np. przekątnej dominującej).
+void LUfactorizationInto(ConstMatrixView A, MatrixView L, MatrixView U, IMnozenie &multImpl);
+
+// Elementy areny zajmowane przez bufory LUfactorizationInto dla macierzy n x n
+std::size_t LUScratchSize(int n);
 
 std::pair<Matrix, Matrix> LUfactorization(const Matrix &A, std::unique_ptr<IMnozenie> &multImpl);
 
-double determinantLU(const Matrix &A, std::unique_ptr<IMnozenie> &multImpl);
\ No newline at end of file
+/**
+ * P A = L U w miejscu, z częściowym wyborem elementu głównego (jak getrf w LAPACK).
+ *
+ * Prawostronny rozkład blokowy: panel kolumn rozkładany jest rekurencyjnie,
+ * wiersz bloków U12 = L11^-1 A12 liczony rozwiązaniem układu trójkątnego,
+ * a reszta macierzy aktualizowana jednym A22 -= L21 U12 przez
+ * multImpl.multiplyAdd. Sam rozkład nie zajmuje buforów (ani areny) i nie
+ * odwraca bloków - kopię A i wektor piv przydzielają wołający
+ * (LUfactorizationPivoted, LUSolver).
+ *
+ * Po wyjściu A zawiera L pod przekątną (jedynki z przekątnej pominięte) i U
+ * na przekątnej i nad nią; piv (rows(A) elementów) - w kroku i wiersz i
+ * zamieniany był z wierszem piv[i]. Zerowy element główny (macierz osobliwa)
+ * - SingularMatrixError, macierz niekwadratowa - std::runtime_error.
+ */
+void LUfactorizationInPlace(MatrixView A, int *piv, IMnozenie &multImpl);
+
+// Rozkład panelu m x n (m >= n) w miejscu, z wyborem elementu głównego w całej
+// kolumnie panelu; piv (n elementów) względem wierszy panelu. Krok
+// LUfactorizationInPlace i kernel panelu rozkładu kafelkowego (Tiled.h).
+void LUpanelFactorization(MatrixView A, int *piv, IMnozenie &multImpl);
+
+// Zamiany wierszy i <-> piv[i] dla i z [k1, k2) w widoku A (jak laswp w LAPACK)
+void applyRowSwaps(MatrixView A, const int *piv, int k1, int k2);
+
+// Kopia A rozłożona LUfactorizationInPlace: spakowane L i U oraz piv
+std::pair<Matrix, std::vector<int>> LUfactorizationPivoted(const Matrix &A, std::unique_ptr<IMnozenie> &multImpl);
+
+// L (z jedynkami na przekątnej) i U rozpakowane z wyniku LUfactorizationInPlace
+std::pair<Matrix, Matrix> unpackLU(ConstMatrixView LU);
+
+// P A - wiersze A zamieniane kolejno i <-> piv[i], tak jak w rozkładzie
+Matrix permuteRows(const Matrix &A, const std::vector<int> &piv);
+
+/**
+ * Rozkład P A = L U liczony raz i używany do wielu układów A X = B.
+ *
+ * Konstruktor rozkłada kopię A (LUfactorizationInPlace); solve to zamiany
+ * wierszy B według piv i dwa rozwiązania trójkątne (trsm, Triangular.h) -
+ * O(n^2 k) zamiast O(n^3) na każdą porcję k prawych stron. multImpl musi
+ * żyć dłużej niż obiekt. Macierz osobliwa - std::runtime_error z konstruktora.
+ */
+class LUSolver {
+public:
+    LUSolver(const Matrix &A, std::unique_ptr<IMnozenie> &multImpl);
+
+    // X = A^-1 B dla B n x k
+    Matrix solve(const Matrix &B) const;
+    // B = A^-1 B w miejscu
+    void solveInto(MatrixView B) const;
+
+    double determinant() const;
+
+    int size() const { return rows(LU_); }
+    // spakowane L i U oraz piv - jak z LUfactorizationPivoted
+    const Matrix &factors() const { return LU_; }
+    const std::vector<int> &pivots() const { return piv_; }
+
+private:
+    Matrix LU_;
+    std::vector<int> piv_;
+    IMnozenie &multImpl_;
+};
+
+// Iloczyn przekątnej U z LUfactorizationPivoted, ze znakiem permutacji
+// (0 dla macierzy osobliwej)
+double determinantLU(const Matrix &A, std::unique_ptr<IMnozenie> &multImpl);
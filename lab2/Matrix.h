@@ -0,0 +1,105 @@
+#pragma once
+#include <vector>
+#include <cstddef>
+#include <initializer_list>
+#include <type_traits>
+
+/**
+ * Nieposiadający widok na prostokątny fragment macierzy: wskaźnik na element
+ * (0, 0), wymiary i leading dimension rodzica. Bloki (block) dzielą pamięć
+ * z macierzą źródłową, więc rekurencyjne algorytmy mogą czytać ćwiartki
+ * i zapisywać wyniki w miejscu, bez subMatrix/combine.
+ */
+template <typename T>
+struct BasicMatrixView {
+    T *data = nullptr;
+    int rows = 0;
+    int cols = 0;
+    int ld = 0;
+
+    BasicMatrixView() = default;
+    BasicMatrixView(T *data, int rows, int cols, int ld)
+        : data(data), rows(rows), cols(cols), ld(ld) {}
+
+    // MatrixView -> ConstMatrixView
+    template <typename U, typename = std::enable_if_t<std::is_convertible_v<U *, T *>>>
+    BasicMatrixView(const BasicMatrixView<U> &v)
+        : data(v.data), rows(v.rows), cols(v.cols), ld(v.ld) {}
+
+    T *operator[](int i) const { return data + static_cast<std::size_t>(i) * ld; }
+
+    BasicMatrixView block(int row, int col, int nrows, int ncols) const {
+        return BasicMatrixView(data + static_cast<std::size_t>(row) * ld + col, nrows, ncols, ld);
+    }
+};
+
+using MatrixView = BasicMatrixView<double>;
+using ConstMatrixView = BasicMatrixView<const double>;
+
+/**
+ * Gęsta macierz w układzie row-major trzymana w jednym, ciągłym buforze.
+ *
+ * Element (i, j) leży pod data()[i * ld() + j]. Leading dimension ld() >= cols()
+ * pozwala wyrównać wiersze (np. do szerokości wektora SIMD) bez zmiany logicznego
+ * rozmiaru. M[i] zwraca wskaźnik na początek wiersza, więc zapis M[i][j] działa
+ * tak jak przy dawnym vector<vector<double>>, ale bez osobnej alokacji na wiersz.
+ */
+class Matrix {
+public:
+    Matrix() = default;
+
+    Matrix(int rows, int cols, double value = 0.0)
+        : Matrix(rows, cols, cols, value) {}
+
+    Matrix(int rows, int cols, int ld, double value)
+        : rows_(rows), cols_(cols), ld_(ld < cols ? cols : ld),
+          buf_(static_cast<std::size_t>(rows) * static_cast<std::size_t>(ld_), value) {}
+
+    Matrix(std::initializer_list<std::initializer_list<double>> init)
+        : Matrix(static_cast<int>(init.size()),
+                 init.size() ? static_cast<int>(init.begin()->size()) : 0) {
+        int i = 0;
+        for (const auto &row : init) {
+            int j = 0;
+            for (double v : row) {
+                if (j < cols_) (*this)[i][j] = v;
+                ++j;
+            }
+            ++i;
+        }
+    }
+
+    int rows() const { return rows_; }
+    int cols() const { return cols_; }
+    int ld() const { return ld_; }
+    bool empty() const { return rows_ == 0 || cols_ == 0; }
+
+    double *data() { return buf_.data(); }
+    const double *data() const { return buf_.data(); }
+
+    double *operator[](int i) { return buf_.data() + static_cast<std::size_t>(i) * ld_; }
+    const double *operator[](int i) const { return buf_.data() + static_cast<std::size_t>(i) * ld_; }
+
+    double &operator()(int i, int j) { return (*this)[i][j]; }
+    double operator()(int i, int j) const { return (*this)[i][j]; }
+
+    MatrixView view() { return MatrixView(data(), rows_, cols_, ld_); }
+    ConstMatrixView view() const { return ConstMatrixView(data(), rows_, cols_, ld_); }
+    operator MatrixView() { return view(); }
+    operator ConstMatrixView() const { return view(); }
+
+    // Widok na blok [row, row + nrows) x [col, col + ncols), bez kopiowania
+    MatrixView block(int row, int col, int nrows, int ncols) { return view().block(row, col, nrows, ncols); }
+    ConstMatrixView block(int row, int col, int nrows, int ncols) const { return view().block(row, col, nrows, ncols); }
+
+private:
+    int rows_ = 0;
+    int cols_ = 0;
+    int ld_ = 0;
+    std::vector<double> buf_;
+};
+
+inline int rows(const Matrix &M) { return M.rows(); }
+inline int cols(const Matrix &M) { return M.cols(); }
+inline int rows(ConstMatrixView V) { return V.rows; }
+inline int cols(ConstMatrixView V) { return V.cols; }
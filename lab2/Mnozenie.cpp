@@ -0,0 +1,38 @@
+#include "Mnozenie.h"
+#include "SupportFunctions.h"
+#include "Arena.h"
+
+#include <stdexcept>
+
+void IMnozenie::multiplyAdd(MatrixView C, double alpha, ConstMatrixView A, ConstMatrixView B, double beta,
+                            Op opA, Op opB) {
+    if (opCols(A, opA) != opRows(B, opB)) {
+        throw std::runtime_error("Incompatible dimensions for multiplication");
+    }
+    if (alpha == 0.0) {
+        scaleAssign(C, beta);
+        return;
+    }
+
+    Arena &arena = threadArena();
+    Arena::Scope scope(arena);
+    if (opA == Op::Trans) {
+        MatrixView At = arena.allocate(A.cols, A.rows);
+        transposeInto(A, At);
+        A = At;
+    }
+    if (opB == Op::Trans) {
+        MatrixView Bt = arena.allocate(B.cols, B.rows);
+        transposeInto(B, Bt);
+        B = Bt;
+    }
+    if (alpha == 1.0 && beta == 0.0) {
+        multiplyInto(A, B, C);
+        return;
+    }
+
+    MatrixView P = arena.allocate(A.rows, B.cols);
+    multiplyInto(A, B, P);
+    scaleAssign(C, beta);
+    axpyAssign(C, alpha, P);
+}
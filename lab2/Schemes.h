@@ -0,0 +1,37 @@
+#pragma once
+
+// Wygenerowane przez AIutils/toscheme.py - nie edytować ręcznie.
+// U[r][i * K + k] - współczynnik A[i][k] w lewym czynniku iloczynu r,
+// V[r][k * N + j] - współczynnik B[k][j] w prawym czynniku,
+// W[i * N + j][r] - współczynnik iloczynu r w C[i][j].
+
+struct Strassen222 {
+    static constexpr int M = 2, K = 2, N = 2, R = 7;
+    static constexpr signed char U[R][M * K] = {
+        {1, 0, 0, 1},
+        {0, 0, 1, 1},
+        {1, 0, 0, 0},
+        {0, 0, 0, 1},
+        {1, 1, 0, 0},
+        {-1, 0, 1, 0},
+        {0, 1, 0, -1},
+    };
+    static constexpr signed char V[R][K * N] = {
+        {1, 0, 0, 1},
+        {1, 0, 0, 0},
+        {0, 1, 0, -1},
+        {-1, 0, 1, 0},
+        {0, 0, 0, 1},
+        {1, 1, 0, 0},
+        {0, 0, 1, 1},
+    };
+    static constexpr signed char W[M * N][R] = {
+        {1, 0, 0, 1, -1, 0, 1},
+        {0, 0, 1, 0, 1, 0, 0},
+        {0, 1, 0, 1, 0, 0, 0},
+        {1, -1, 1, 0, 0, 1, 0},
+    };
+    static constexpr int u(int r, int e) { return U[r][e]; }
+    static constexpr int v(int r, int e) { return V[r][e]; }
+    static constexpr int w(int o, int r) { return W[o][r]; }
+};
@@ -0,0 +1,38 @@
+#pragma once
+
+/**
+ * Jądra wektorowe (AVX2 / AVX-512) z wersją skalarną jako fallback.
+ *
+ * Zestaw instrukcji wybierany jest raz, przy pierwszym użyciu, na podstawie
+ * cpuid (__builtin_cpu_supports), więc ta sama binarka działa na maszynach
+ * z samym AVX2 i z AVX-512. Zmienna środowiskowa MATRIX_SIMD=scalar|avx2|avx512
+ * pozwala wymusić słabszy wariant (np. do porównań).
+ *
+ * Funkcje operują na surowych wskaźnikach i nie liczą operacji - liczniki
+ * aktualizuje wywołujący, hurtowo.
+ */
+enum class SimdIsa { Scalar, Avx2, Avx512 };
+
+SimdIsa simdIsa();
+const char *simdIsaName(SimdIsa isa);
+
+double simdDot(int n, const double *x, const double *y);                       // x . y
+void simdAxpy(int n, double alpha, const double *x, double *y);                // y += alpha * x
+void simdAdd(int n, const double *x, const double *y, double *z);              // z = x + y
+void simdSub(int n, const double *x, const double *y, double *z);              // z = x - y
+void simdGemv(int m, int n, const double *A, int lda, const double *x, double *y); // y = A * x
+void simdGram(int m, int n, const double *A, int lda, double *G, int ldg);     // G = A^T * A
+
+/**
+ * Mikrojądro GEMM: kafel mr x nr wyniku C (= albo +=) z panelu Ap (kc x MR,
+ * Ap[p * MR + i]) i panelu Bp (kc x NR, Bp[p * NR + j]). MR i NR zależą od
+ * wybranego zestawu instrukcji, więc pakowanie musi korzystać z tych pól.
+ */
+struct SimdGemmKernel {
+    int MR;
+    int NR;
+    void (*run)(int kc, const double *Ap, const double *Bp,
+                double *C, int ldc, int mr, int nr, bool accumulate);
+};
+
+const SimdGemmKernel &simdGemmKernel();
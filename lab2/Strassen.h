@@ -6,6 +6,26 @@
 /**
  * Fabryka zwracająca implementację IMnozenie opartą o algorytm Strassena.
  *
+ * Obsługuje dowolne m x k * k x n: kształt wydłużony (najdłuższy wymiar > 2x
+ * najkrótszy) dzielony jest na połowy wzdłuż najdłuższego wymiaru, aż będzie
+ * bliski kwadratowi, a nieparzyste wymiary obsługuje dynamic peeling - bez
+ * dopełniania do kwadratu potęgi dwójki.
+ *
+ * Podproblemy, w których któryś wymiar jest <= leafSize, liczone są blokowym
+ * gemm zamiast dalszej rekurencji; leafSize <= 1 daje rekurencję aż do 1x1.
+ * Kwadraty 2 i 4 (oraz liście do 4x4) liczą jądra z FixedKernels.h - z tymi
+ * samymi operacjami co rekurencja.
+ * Pierwsze parallelDepth poziomów rekurencji (po 7 iloczynów na poziom)
+ * wykonywane jest równolegle w puli wątków; 0 oznacza wersję sekwencyjną.
+ *
  * Deklaracja tutaj umożliwia użycie implementacji bez ujawniania szczegółów.
  */
-std::unique_ptr<IMnozenie> createStrassen();
\ No newline at end of file
+std::unique_ptr<IMnozenie> createStrassen(int leafSize = 64, int parallelDepth = 0);
+
+/**
+ * Dobiera leafSize dla createStrassen: dla kolejnych rozmiarów n <= maxSize
+ * porównuje czas jednego poziomu Strassena (połówki liczone gemm) z samym
+ * gemm i zwraca największy rozmiar, dla którego rekurencja się jeszcze nie
+ * opłaca. Zmienia liczniki operacji i pamięci - wywoływać przed pomiarami.
+ */
+int tuneStrassenLeafSize(int maxSize = 2048);
@@ -3,6 +3,8 @@
 #include "Mnozenie.h"
 #include <iostream>
 #include <cstdint>
+#include <string>
+#include <vector>
 
 Matrix createRandomMatrix(int m, int n);
 Matrix createRandomMatrix(int n);
@@ -22,10 +24,26 @@ Matrix negate(const Matrix &A);
 std::pair<bool,double> compareMatrices(const Matrix& X, const Matrix& Y, double tol);
 Matrix pad(const Matrix& A, int rows, int cols);
 Matrix trim(const Matrix& A, int rows, int cols);
-int rows(const Matrix& M);
-int cols(const Matrix& M);
+
+// operacje na widokach - wynik zapisywany w miejscu, bez alokacji
+void setZero(MatrixView C);
+void copyInto(ConstMatrixView A, MatrixView C);
+void addInto(ConstMatrixView A, ConstMatrixView B, MatrixView C);   // C = A + B
+void subInto(ConstMatrixView A, ConstMatrixView B, MatrixView C);   // C = A - B
+void addAssign(MatrixView C, ConstMatrixView A);                    // C += A
+void subAssign(MatrixView C, ConstMatrixView A);                    // C -= A
+void scaleAssign(MatrixView C, double beta);                        // C *= beta (0 - zerowanie)
+void axpyAssign(MatrixView C, double alpha, ConstMatrixView A);     // C += alpha * A
+void transposeInto(ConstMatrixView A, MatrixView C);                // C = A^T
+void negateInto(ConstMatrixView A, MatrixView C);                   // C = -A
+// C = A * B (accumulate = false) albo C += A * B (accumulate = true)
+void multiplyInto(ConstMatrixView A, ConstMatrixView B, MatrixView C, bool accumulate = false);
 
 // Op counter
+// Każdy wątek liczy do własnych liczników (bez atomowych operacji w jądrach),
+// opCounterGet sumuje je przy odczycie, a reset zapamiętuje stan do odjęcia,
+// więc można go wołać także w trakcie pracy puli. Kompilacja z -DMATRIX_NO_INSTRUMENTATION
+// zamienia wszystkie funkcje liczników na puste funkcje inline.
 struct OpCounts {
     std::uint64_t adds = 0;
     std::uint64_t subs = 0;
@@ -33,22 +51,70 @@ struct OpCounts {
     std::uint64_t divs = 0;
 };
 
-void opCounterReset();
-OpCounts opCounterGet();
-void opCounterAdd(const OpCounts &c); // optional helper
-
 // Memory accounting (approximate, based on recursive calls)
 // current_bytes = currently accounted bytes (sum over active calls of p*r*sizeof(double))
-// peak_bytes = maximal observed current_bytes
+// peak_bytes = maximal observed current_bytes (liczniki też są per wątek: szczyt
+// globalny to suma szczytów wątków - dokładny dla jednego wątku, przy wielu
+// ograniczenie górne)
 // active_calls / peak_calls = number of active recursive calls (instantaneous / peak)
+// arena_current_bytes / arena_peak_bytes = bufory faktycznie zajęte w arenach (Arena.h)
 struct MemStats {
     std::uint64_t current_bytes = 0;
     std::uint64_t peak_bytes = 0;
     std::uint64_t active_calls = 0;
     std::uint64_t peak_calls = 0;
+    std::uint64_t arena_current_bytes = 0;
+    std::uint64_t arena_peak_bytes = 0;
 };
 
+// Faktyczne alokacje - AllocCounter.cpp podmienia globalne operator new/delete.
+// live_bytes = bajty zaalokowane w tej chwili, peak_bytes = maksimum live_bytes
+// od ostatniego resetu (razem z tym, co już było zaalokowane przy resecie),
+// alloc_count = liczba alokacji od resetu,
+// histogram[k] = liczba alokacji o rozmiarze z przedziału [2^k, 2^(k+1)) bajtów
+struct AllocStats {
+    static constexpr int kBuckets = 48;
+    std::uint64_t live_bytes = 0;
+    std::uint64_t peak_bytes = 0;
+    std::uint64_t alloc_count = 0;
+    std::uint64_t histogram[kBuckets] = {};
+};
+
+// Niezerowe kubełki histogramu jako "k:liczba,k:liczba" ("-" gdy pusty)
+std::string allocHistogramString(const AllocStats &stats);
+
+#ifndef MATRIX_NO_INSTRUMENTATION
+constexpr bool instrumentationEnabled = true;
+
+void opCounterReset();
+OpCounts opCounterGet();
+void opCounterAdd(const OpCounts &c); // optional helper
+
 void memCounterReset();
-void memCounterEnterCall(int p, int r, int n); // account for p*r*sizeof(double)
-void memCounterExitCall(int p, int r, int n);
-MemStats memCounterGet();
\ No newline at end of file
+void memCounterEnterCall(std::size_t p, std::size_t r, int n); // account for p*r*sizeof(double)
+void memCounterExitCall(std::size_t p, std::size_t r, int n);
+void memCounterArenaAlloc(std::size_t bytes);
+void memCounterArenaRelease(std::size_t bytes);
+MemStats memCounterGet();                         // suma po wątkach (także zakończonych)
+std::vector<MemStats> memCounterGetPerThread();   // osobno dla każdego żyjącego wątku
+
+void allocCounterReset(); // wołane także przez memCounterReset
+AllocStats allocCounterGet();
+#else
+constexpr bool instrumentationEnabled = false;
+
+inline void opCounterReset() {}
+inline OpCounts opCounterGet() { return OpCounts{}; }
+inline void opCounterAdd(const OpCounts &) {}
+
+inline void memCounterReset() {}
+inline void memCounterEnterCall(std::size_t, std::size_t, int) {}
+inline void memCounterExitCall(std::size_t, std::size_t, int) {}
+inline void memCounterArenaAlloc(std::size_t) {}
+inline void memCounterArenaRelease(std::size_t) {}
+inline MemStats memCounterGet() { return MemStats{}; }
+inline std::vector<MemStats> memCounterGetPerThread() { return {}; }
+
+inline void allocCounterReset() {}
+inline AllocStats allocCounterGet() { return AllocStats{}; }
+#endif
\ No newline at end of file
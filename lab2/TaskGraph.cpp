@@ -0,0 +1,63 @@
+#include "TaskGraph.h"
+
+void TaskGraph::addEdge(int from, int to) {
+    // krawędzie do zadania dodawane są razem, w add(), więc powtórzona
+    // krawędź może być tylko ostatnią krawędzią poprzednika
+    std::vector<int> &succ = nodes_[from]->successors;
+    if (!succ.empty() && succ.back() == to) return;
+    succ.push_back(to);
+    ++nodes_[to]->dependencies;
+}
+
+void TaskGraph::add(std::function<void()> task, const std::vector<int> &reads, const std::vector<int> &writes) {
+    int id = size();
+    nodes_.push_back(std::make_unique<Node>());
+    nodes_.back()->task = std::move(task);
+
+    for (int tile : reads) {
+        TileState &state = tiles_[tile];
+        if (state.lastWriter >= 0) addEdge(state.lastWriter, id);
+        state.readers.push_back(id);
+    }
+    for (int tile : writes) {
+        TileState &state = tiles_[tile];
+        if (state.lastWriter >= 0) addEdge(state.lastWriter, id);
+        for (int reader : state.readers)
+            if (reader != id) addEdge(reader, id);
+        state.lastWriter = id;
+        state.readers.clear();
+    }
+}
+
+void TaskGraph::launch(TaskGroup &group, int node) {
+    group.run([this, &group, node] {
+        Node &n = *nodes_[node];
+        n.task();
+        // wątek zdejmuje własne zadania od końca kolejki - następniki
+        // wrzucane od ostatniego, żeby najpierw wykonał się najwcześniej
+        // dodany (zwykle ten na ścieżce krytycznej, np. następny panel)
+        for (auto it = n.successors.rbegin(); it != n.successors.rend(); ++it) {
+            if (--nodes_[*it]->remaining == 0) launch(group, *it);
+        }
+    });
+}
+
+void TaskGraph::run(ThreadPool *pool) {
+    try {
+        if (!pool) {
+            for (auto &node : nodes_) node->task();
+        } else {
+            TaskGroup group(pool);
+            for (auto &node : nodes_) node->remaining = node->dependencies;
+            for (int i = 0; i < size(); ++i)
+                if (nodes_[i]->dependencies == 0) launch(group, i);
+            group.wait();
+        }
+    } catch (...) {
+        nodes_.clear();
+        tiles_.clear();
+        throw;
+    }
+    nodes_.clear();
+    tiles_.clear();
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include "ThreadPool.h"
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * Graf zadań na kafelkach macierzy (model jak w StarPU / PLASMA).
+ *
+ * Zadania dodawane są w kolejności algorytmu sekwencyjnego razem z listą
+ * kafelków, które czytają i zapisują (kafelki to dowolne identyfikatory
+ * nadawane przez wywołującego). Zależności wynikają z tej kolejności:
+ * odczyt czeka na ostatni zapis kafelka (RAW), zapis - na ostatni zapis
+ * i wszystkie odczyty od niego (WAW, WAR). run() zleca puli zadania, których
+ * poprzedniki się zakończyły, więc niezależne kernele kafelkowe (np.
+ * aktualizacje różnych kafelków i rozkład następnego panelu) wykonują się
+ * jednocześnie, bez barier między krokami algorytmu.
+ */
+class TaskGraph {
+public:
+    void add(std::function<void()> task, const std::vector<int> &reads, const std::vector<int> &writes);
+
+    // Wykonuje wszystkie zadania i czyści graf. Bez puli (pool == nullptr) -
+    // po kolei, w kolejności dodania. Pierwszy wyjątek z zadania jest rzucany
+    // ponownie po zakończeniu pozostałych zadań, które nie zależały od niego.
+    void run(ThreadPool *pool);
+
+    int size() const { return static_cast<int>(nodes_.size()); }
+
+private:
+    struct Node {
+        std::function<void()> task;
+        std::vector<int> successors;
+        int dependencies = 0;
+        std::atomic<int> remaining{0};
+    };
+
+    struct TileState {
+        int lastWriter = -1;
+        std::vector<int> readers; // od ostatniego zapisu
+    };
+
+    void addEdge(int from, int to);
+    void launch(TaskGroup &group, int node);
+
+    std::vector<std::unique_ptr<Node>> nodes_;
+    std::unordered_map<int, TileState> tiles_;
+};
@@ -0,0 +1,192 @@
+#include "Tiled.h"
+#include "SupportFunctions.h"
+#include "LUfactorization.h"
+#include "TaskGraph.h"
+#include "ThreadPool.h"
+#include "Triangular.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace {
+
+// Podział n wierszy (i kolumn) na kafelki po ts, ostatni może być mniejszy
+struct Tiling {
+    int n, ts, nt;
+    Tiling(int n, int ts) : n(n), ts(ts), nt((n + ts - 1) / ts) {}
+    int start(int i) const { return i * ts; }
+    int size(int i) const { return std::min(ts, n - i * ts); }
+    MatrixView tile(MatrixView M, int i, int j) const { return M.block(start(i), start(j), size(i), size(j)); }
+};
+
+ThreadPool *tilePool() {
+    return threadPoolSize() > 1 ? &threadPool() : nullptr;
+}
+
+void checkTileSize(int tileSize) {
+    if (tileSize <= 0) throw std::runtime_error("Tile size must be positive");
+}
+
+// Kafelki A mają identyfikatory i * (nt + 1) + j; kolumna j == nt to prawe strony B
+int tileId(const Tiling &t, int i, int j) {
+    return i * (t.nt + 1) + j;
+}
+
+// Kernele rozkładu P A = L U dodawane do grafu. B (n x r, r może być 0) dostaje
+// te same zamiany wierszy i L^-1 co kolumny A na prawo od paneli. swapLeft -
+// zamiany z późniejszych paneli stosowane też w L (pomijane, gdy L nie jest
+// dalej potrzebne).
+void addLU(TaskGraph &graph, MatrixView A, MatrixView B, int *piv, const Tiling &t, IMnozenie &multImpl,
+           bool swapLeft) {
+    int n = t.n, nt = t.nt;
+    int ncols = B.cols > 0 ? nt + 1 : nt;
+    // kolumna kafelków j od wiersza kafelków i do końca
+    auto column = [&](int i, int j) {
+        return j < nt ? A.block(t.start(i), t.start(j), n - t.start(i), t.size(j))
+                      : B.block(t.start(i), 0, n - t.start(i), B.cols);
+    };
+    auto tile = [&](int i, int j) { return column(i, j).block(0, 0, t.size(i), column(i, j).cols); };
+
+    std::vector<int> reads, writes;
+    for (int k = 0; k < nt; ++k) {
+        int r0 = t.start(k), nb = t.size(k);
+
+        // panel - cała kolumna kafelków k, wybór elementu głównego po wszystkich wierszach
+        writes.clear();
+        for (int i = k; i < nt; ++i) writes.push_back(tileId(t, i, k));
+        MatrixView panel = column(k, k);
+        graph.add([panel, piv, r0, nb, &multImpl] {
+            LUpanelFactorization(panel, piv + r0, multImpl);
+            for (int i = r0; i < r0 + nb; ++i) piv[i] += r0;
+        }, {}, writes);
+
+        // zamiany wierszy panelu i U_kj = L_kk^-1 A_kj w każdej kolumnie na prawo
+        ConstMatrixView Lkk = tile(k, k);
+        for (int j = k + 1; j < ncols; ++j) {
+            writes.clear();
+            for (int i = k; i < nt; ++i) writes.push_back(tileId(t, i, j));
+            MatrixView col = column(0, j), Ukj = tile(k, j);
+            graph.add([col, Ukj, Lkk, piv, r0, nb, &multImpl] {
+                applyRowSwaps(col, piv, r0, r0 + nb);
+                trsm(Side::Left, Uplo::Lower, Diag::Unit, Lkk, Ukj, multImpl);
+            }, {tileId(t, k, k)}, writes);
+        }
+
+        // A_ij -= L_ik U_kj - niezależne kernele, po jednym na kafelek
+        for (int i = k + 1; i < nt; ++i) {
+            for (int j = k + 1; j < ncols; ++j) {
+                MatrixView Aij = tile(i, j);
+                ConstMatrixView Lik = tile(i, k), Ukj = tile(k, j);
+                graph.add([Aij, Lik, Ukj, &multImpl] { multImpl.multiplyAdd(Aij, -1.0, Lik, Ukj, 1.0); },
+                          {tileId(t, i, k), tileId(t, k, j)}, {tileId(t, i, j)});
+            }
+        }
+    }
+
+    if (!swapLeft) return;
+    // zamiany z paneli k > j w kolumnie kafelków j (jak na końcu getrf)
+    for (int j = 0; j + 1 < nt; ++j) {
+        reads.clear();
+        writes.clear();
+        for (int k = j + 1; k < nt; ++k) {
+            reads.push_back(tileId(t, k, k));
+            writes.push_back(tileId(t, k, j));
+        }
+        MatrixView col = column(0, j);
+        int from = t.start(j + 1);
+        graph.add([col, piv, from, n] { applyRowSwaps(col, piv, from, n); }, reads, writes);
+    }
+}
+
+} // namespace
+
+std::pair<Matrix, std::vector<int>> LUfactorizationTiled(const Matrix &A, std::unique_ptr<IMnozenie> &multImpl,
+                                                         int tileSize) {
+    int n = rows(A);
+    if (cols(A) != n) throw std::runtime_error("LU factorization: matrix must be square");
+    checkTileSize(tileSize);
+
+    Matrix LU = A;
+    std::vector<int> piv(n);
+    TaskGraph graph;
+    addLU(graph, LU, MatrixView(), piv.data(), Tiling(n, tileSize), *multImpl, true);
+    graph.run(tilePool());
+    return {std::move(LU), std::move(piv)};
+}
+
+std::pair<Matrix, Matrix> GaussEliminationTiled(const Matrix &A, const Matrix &b, std::unique_ptr<IMnozenie> &multImpl,
+                                                int tileSize) {
+    int n = rows(A);
+    if (cols(A) != n || rows(b) != n) throw std::runtime_error("Incompatible dimensions for Gauss elimination");
+    checkTileSize(tileSize);
+
+    // L nie wchodzi do wyniku - bez zamian wierszy na lewo od paneli
+    Matrix C = A, c = b;
+    std::vector<int> piv(n);
+    TaskGraph graph;
+    addLU(graph, C, c, piv.data(), Tiling(n, tileSize), *multImpl, false);
+    graph.run(tilePool());
+
+    for (int i = 1; i < n; ++i) std::fill(C[i], C[i] + i, 0.0);
+    return {std::move(C), std::move(c)};
+}
+
+Matrix inverseTiled(const Matrix &A, std::unique_ptr<IMnozenie> &multImpl, int tileSize) {
+    int n = rows(A);
+    if (cols(A) != n) throw std::runtime_error("Inverse: matrix must be square");
+    checkTileSize(tileSize);
+
+    Matrix LU = A;
+    Matrix X = identityMatrix(n);
+    std::vector<int> piv(n);
+    Tiling t(n, tileSize);
+    int nt = t.nt;
+    IMnozenie &impl = *multImpl;
+
+    TaskGraph graph;
+    addLU(graph, LU, MatrixView(), piv.data(), t, impl, true);
+
+    // kafelki X za kafelkami A
+    auto xId = [&t, nt](int i, int j) { return tileId(t, nt, 0) + i * nt + j; };
+
+    // X = L^-1: w kolumnie kafelków j kafelki nad przekątną są i zostają zerowe
+    for (int j = 0; j < nt; ++j) {
+        for (int k = j; k < nt; ++k) {
+            ConstMatrixView Lkk = t.tile(LU, k, k);
+            MatrixView Xkj = t.tile(X, k, j);
+            graph.add([Lkk, Xkj, &impl] { trsm(Side::Left, Uplo::Lower, Diag::Unit, Lkk, Xkj, impl); },
+                      {tileId(t, k, k)}, {xId(k, j)});
+            for (int i = k + 1; i < nt; ++i) {
+                ConstMatrixView Lik = t.tile(LU, i, k);
+                MatrixView Xij = t.tile(X, i, j);
+                graph.add([Xij, Lik, Xkj, &impl] { impl.multiplyAdd(Xij, -1.0, Lik, Xkj, 1.0); },
+                          {tileId(t, i, k), xId(k, j)}, {xId(i, j)});
+            }
+        }
+    }
+
+    // X = U^-1 X
+    for (int j = 0; j < nt; ++j) {
+        for (int k = nt - 1; k >= 0; --k) {
+            ConstMatrixView Ukk = t.tile(LU, k, k);
+            MatrixView Xkj = t.tile(X, k, j);
+            graph.add([Ukk, Xkj, &impl] { trsm(Side::Left, Uplo::Upper, Diag::NonUnit, Ukk, Xkj, impl); },
+                      {tileId(t, k, k)}, {xId(k, j)});
+            for (int i = 0; i < k; ++i) {
+                ConstMatrixView Uik = t.tile(LU, i, k);
+                MatrixView Xij = t.tile(X, i, j);
+                graph.add([Xij, Uik, Xkj, &impl] { impl.multiplyAdd(Xij, -1.0, Uik, Xkj, 1.0); },
+                          {tileId(t, i, k), xId(k, j)}, {xId(i, j)});
+            }
+        }
+    }
+
+    graph.run(tilePool());
+
+    // A^-1 = U^-1 L^-1 P - zamiany kolumn w odwrotnej kolejności
+    for (int i = n - 1; i >= 0; --i) {
+        if (piv[i] == i) continue;
+        for (int r = 0; r < n; ++r) std::swap(X[r][i], X[r][piv[i]]);
+    }
+    return X;
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include "Mnozenie.h"
+#include <utility>
+#include <vector>
+
+/**
+ * Kafelkowe wersje LU, eliminacji Gaussa i odwracania (jak w PLASMA).
+ *
+ * Macierz dzielona jest na kafelki tileSize x tileSize, a algorytm zapisywany
+ * jako ciąg kerneli na kafelkach - rozkład panelu (kolumny kafelków, z wyborem
+ * elementu głównego), zamiany wierszy z TRSM w kolumnach na prawo od panelu
+ * i aktualizacje A_ij -= L_ik U_kj przez multImpl.multiplyAdd. Kernele trafiają
+ * do TaskGraph (TaskGraph.h), który wykonuje je na wspólnej puli wątków
+ * według zależności między kafelkami: aktualizacje różnych kafelków idą
+ * równolegle, a panel k + 1 startuje, gdy tylko gotowa jest jego kolumna,
+ * bez czekania na resztę kroku k. Przy jednowątkowej puli kernele wykonywane
+ * są po kolei.
+ *
+ * Wszystkie trzy wersje pivotują, więc nie wymagają niezerowych wiodących
+ * minorów; macierz osobliwa - std::runtime_error.
+ */
+constexpr int kTileSize = 128;
+
+// P A = L U - wynik i piv jak w LUfactorizationPivoted (LUfactorization.h)
+std::pair<Matrix, std::vector<int>> LUfactorizationTiled(const Matrix &A, std::unique_ptr<IMnozenie> &multImpl,
+                                                         int tileSize = kTileSize);
+
+// A x = b sprowadzone do C x = c: C = U (zera pod przekątną), c = L^-1 P b
+std::pair<Matrix, Matrix> GaussEliminationTiled(const Matrix &A, const Matrix &b, std::unique_ptr<IMnozenie> &multImpl,
+                                                int tileSize = kTileSize);
+
+// A^-1 = U^-1 L^-1 P: L^-1 kolumnami kafelków (bez kafelków nad przekątną,
+// które są zerowe), potem U^-1 i zamiany kolumn jak w getri
+Matrix inverseTiled(const Matrix &A, std::unique_ptr<IMnozenie> &multImpl, int tileSize = kTileSize);
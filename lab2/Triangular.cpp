@@ -0,0 +1,158 @@
+#include "Triangular.h"
+#include "SupportFunctions.h"
+#include "BatchedGemm.h"
+#include "Simd.h"
+
+#include <stdexcept>
+
+namespace {
+
+// Liść TRSV - podstawianie iloczynami skalarnymi na kopii x w tablicy
+// (x w widoku może mieć ld > 1)
+constexpr int kTrsvLeaf = 64;
+
+// B = T^-1 B podstawianiem wierszami: wiersz i B pomniejszany o T[i][p] B[p]
+// dla już rozwiązanych wierszy p, potem dzielony przez T[i][i]
+void leafLeft(Uplo uplo, Diag diag, ConstMatrixView T, MatrixView B) {
+    int k = T.rows, n = B.cols;
+    for (int s = 0; s < k; ++s) {
+        int i = uplo == Uplo::Lower ? s : k - 1 - s;
+        int p0 = uplo == Uplo::Lower ? 0 : i + 1, p1 = uplo == Uplo::Lower ? i : k;
+        for (int p = p0; p < p1; ++p) simdAxpy(n, -T[i][p], B[p], B[i]);
+        if (diag == Diag::NonUnit) {
+            double r = 1.0 / T[i][i];
+            for (int j = 0; j < n; ++j) B[i][j] *= r;
+        }
+    }
+    std::uint64_t ops = static_cast<std::uint64_t>(k) * (k - 1) / 2 * n;
+    if (diag == Diag::NonUnit) {
+        opCounterAdd({0, ops, ops + static_cast<std::uint64_t>(k) * n, static_cast<std::uint64_t>(k)});
+    } else {
+        opCounterAdd({0, ops, ops, 0});
+    }
+}
+
+// B = B T^-1, osobno dla każdego wiersza x = b: rozwiązana kolumna j
+// odejmowana jest od pozostałych z wierszem T[j] (ciągłym w pamięci) -
+// dla górnotrójkątnej od lewej, dla dolnotrójkątnej od prawej
+void leafRight(Uplo uplo, Diag diag, ConstMatrixView T, MatrixView B) {
+    int k = T.rows, m = B.rows;
+    double recip[kTrsmLeaf];
+    if (diag == Diag::NonUnit)
+        for (int j = 0; j < k; ++j) recip[j] = 1.0 / T[j][j];
+
+    for (int r = 0; r < m; ++r) {
+        double *x = B[r];
+        for (int s = 0; s < k; ++s) {
+            int j = uplo == Uplo::Upper ? s : k - 1 - s;
+            if (diag == Diag::NonUnit) x[j] *= recip[j];
+            if (uplo == Uplo::Upper) {
+                simdAxpy(k - j - 1, -x[j], T[j] + j + 1, x + j + 1);
+            } else {
+                simdAxpy(j, -x[j], T[j], x);
+            }
+        }
+    }
+    std::uint64_t ops = static_cast<std::uint64_t>(k) * (k - 1) / 2 * m;
+    if (diag == Diag::NonUnit) {
+        opCounterAdd({0, ops, ops + static_cast<std::uint64_t>(k) * m, static_cast<std::uint64_t>(k)});
+    } else {
+        opCounterAdd({0, ops, ops, 0});
+    }
+}
+
+// Dla T = [T11 0; T21 T22] (Lower) albo [T11 T12; 0 T22] (Upper) najpierw
+// rozwiązywana jest ta połowa, która nie zależy od drugiej, a jej wynik
+// odejmowany od prawych stron drugiej połowy
+void trsmRec(Side side, Uplo uplo, Diag diag, ConstMatrixView T, MatrixView B, IMnozenie &multImpl) {
+    int k = T.rows;
+    if (k <= kTrsmLeaf) {
+        if (side == Side::Left) {
+            leafLeft(uplo, diag, T, B);
+        } else {
+            leafRight(uplo, diag, T, B);
+        }
+        return;
+    }
+
+    int h = k / 2;
+    ConstMatrixView T11 = T.block(0, 0, h, h), T22 = T.block(h, h, k - h, k - h);
+    ConstMatrixView T12 = T.block(0, h, h, k - h), T21 = T.block(h, 0, k - h, h);
+
+    if (side == Side::Left) {
+        MatrixView B1 = B.block(0, 0, h, B.cols), B2 = B.block(h, 0, k - h, B.cols);
+        if (uplo == Uplo::Lower) {
+            trsmRec(side, uplo, diag, T11, B1, multImpl);
+            multiplyAddSmall(multImpl, B2, -1.0, T21, B1, 1.0);
+            trsmRec(side, uplo, diag, T22, B2, multImpl);
+        } else {
+            trsmRec(side, uplo, diag, T22, B2, multImpl);
+            multiplyAddSmall(multImpl, B1, -1.0, T12, B2, 1.0);
+            trsmRec(side, uplo, diag, T11, B1, multImpl);
+        }
+    } else {
+        MatrixView B1 = B.block(0, 0, B.rows, h), B2 = B.block(0, h, B.rows, k - h);
+        if (uplo == Uplo::Lower) {
+            trsmRec(side, uplo, diag, T22, B2, multImpl);
+            multiplyAddSmall(multImpl, B1, -1.0, B2, T21, 1.0);
+            trsmRec(side, uplo, diag, T11, B1, multImpl);
+        } else {
+            trsmRec(side, uplo, diag, T11, B1, multImpl);
+            multiplyAddSmall(multImpl, B2, -1.0, B1, T12, 1.0);
+            trsmRec(side, uplo, diag, T22, B2, multImpl);
+        }
+    }
+}
+
+void trsvRec(Uplo uplo, Diag diag, ConstMatrixView T, MatrixView x, IMnozenie &multImpl) {
+    int k = T.rows;
+    if (k <= kTrsvLeaf) {
+        double v[kTrsvLeaf];
+        for (int i = 0; i < k; ++i) v[i] = x[i][0];
+        for (int s = 0; s < k; ++s) {
+            int i = uplo == Uplo::Lower ? s : k - 1 - s;
+            v[i] -= uplo == Uplo::Lower ? simdDot(i, T[i], v) : simdDot(k - i - 1, T[i] + i + 1, v + i + 1);
+            if (diag == Diag::NonUnit) v[i] /= T[i][i];
+        }
+        for (int i = 0; i < k; ++i) x[i][0] = v[i];
+        std::uint64_t ops = static_cast<std::uint64_t>(k) * (k - 1) / 2;
+        opCounterAdd({0, ops, ops, diag == Diag::NonUnit ? static_cast<std::uint64_t>(k) : 0});
+        return;
+    }
+
+    int h = k / 2;
+    MatrixView x1 = x.block(0, 0, h, 1), x2 = x.block(h, 0, k - h, 1);
+    if (uplo == Uplo::Lower) {
+        trsvRec(uplo, diag, T.block(0, 0, h, h), x1, multImpl);
+        multiplyAddSmall(multImpl, x2, -1.0, T.block(h, 0, k - h, h), x1, 1.0);
+        trsvRec(uplo, diag, T.block(h, h, k - h, k - h), x2, multImpl);
+    } else {
+        trsvRec(uplo, diag, T.block(h, h, k - h, k - h), x2, multImpl);
+        multiplyAddSmall(multImpl, x1, -1.0, T.block(0, h, h, k - h), x2, 1.0);
+        trsvRec(uplo, diag, T.block(0, 0, h, h), x1, multImpl);
+    }
+}
+
+} // namespace
+
+void trsm(Side side, Uplo uplo, Diag diag, ConstMatrixView T, MatrixView B, IMnozenie &multImpl) {
+    int k = side == Side::Left ? B.rows : B.cols;
+    if (T.rows != T.cols || T.rows != k) {
+        throw std::runtime_error("Incompatible dimensions for triangular solve");
+    }
+    if (k == 0 || B.rows == 0 || B.cols == 0) return;
+    // jedna prawa strona - iloczyny skalarne zamiast axpy długości 1
+    if (side == Side::Left && B.cols == 1) {
+        trsvRec(uplo, diag, T, B, multImpl);
+        return;
+    }
+    trsmRec(side, uplo, diag, T, B, multImpl);
+}
+
+void trsv(Uplo uplo, Diag diag, ConstMatrixView T, MatrixView x, IMnozenie &multImpl) {
+    if (T.rows != T.cols || T.rows != x.rows || x.cols != 1) {
+        throw std::runtime_error("Incompatible dimensions for triangular solve");
+    }
+    if (T.rows == 0) return;
+    trsvRec(uplo, diag, T, x, multImpl);
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include "Mnozenie.h"
+
+/**
+ * Układy trójkątne z wieloma prawymi stronami (TRSM) i z jedną (TRSV),
+ * rozwiązywane w miejscu - bez odwracania macierzy trójkątnej.
+ *
+ * Rekurencja dzieli T na połowy: T11 rozwiązywane rekurencyjnie, poprawka
+ * prawych stron przez blok pozadiagonalny (jedno multiplyAdd backendu, małe
+ * bloki bezpośrednio gemm - BatchedGemm.h), T22 rekurencyjnie. Bloki do
+ * kTrsmLeaf wierszy - podstawianie wierszami B (simdAxpy / simdDot).
+ *
+ * Czytany jest tylko trójkąt uplo macierzy T (dla Diag::Unit bez przekątnej,
+ * przyjmowanej jako jedynki), więc T może być spakowanym wynikiem rozkładu LU.
+ * Zerowa przekątna nie jest sprawdzana.
+ */
+enum class Side { Left, Right };       // T^-1 B albo B T^-1
+enum class Uplo { Lower, Upper };
+enum class Diag { NonUnit, Unit };
+
+constexpr int kTrsmLeaf = 16;
+
+// Side::Left: B = T^-1 B (rows(B) == rows(T)), Side::Right: B = B T^-1
+// (cols(B) == rows(T)); T kwadratowa, B nadpisywane wynikiem. Side::Left
+// z jedną kolumną B liczone jest jak trsv.
+void trsm(Side side, Uplo uplo, Diag diag, ConstMatrixView T, MatrixView B, IMnozenie &multImpl);
+
+// x = T^-1 x dla wektora kolumnowego x (rows(T) x 1)
+void trsv(Uplo uplo, Diag diag, ConstMatrixView T, MatrixView x, IMnozenie &multImpl);
@@ -0,0 +1,117 @@
+#include <algorithm>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "SupportFunctions.h"
+#include "Mnozenie.h"
+#include "Binet.h"
+#include "Strassen.h"
+#include "Winograd.h"
+#include "Gemm.h"
+#include "Inverse.h"
+#include "LUfactorization.h"
+#include "GaussElimination.h"
+#include "Tiled.h"
+#include "ThreadPool.h"
+#include "Benchmark.h"
+#include "Auto.h"
+
+// Liczba operacji jednego uruchomienia z liczników (jedno dodatkowe, niemierzone
+// wywołanie); w wersji fast liczniki są wyłączone i używane jest fallback.
+static double countFlops(const std::function<void()> &run, double fallback) {
+    if (!instrumentationEnabled) return fallback;
+    opCounterReset();
+    run();
+    OpCounts ops = opCounterGet();
+    return static_cast<double>(ops.adds + ops.subs + ops.muls + ops.divs);
+}
+
+int main(int argc, char **argv) {
+    BenchConfig config;
+    try {
+        config = parseBenchArgs(argc, argv, {128, 256, 512});
+    } catch (const std::exception &e) {
+        std::cerr << e.what() << "\n"
+                  << "Usage: " << argv[0] << " [--warmup W] [--reps R] [--cpu C] [--threads T]"
+                  << " [--format csv|json] [--out FILE] [N...]\n";
+        return 1;
+    }
+
+    if (config.cpu >= 0 && !pinCurrentThread(config.cpu)) {
+        std::cerr << "Can't pin thread to cpu " << config.cpu << "\n";
+    }
+    threadPoolSetSize(config.threads, config.cpu);
+
+    struct Backend {
+        std::string name;
+        std::unique_ptr<IMnozenie> impl;
+    };
+    // liść Strassena dobierany pomiarem przed benchmarkami (zmienia liczniki);
+    // większy od największego rozmiaru niczego już nie zmienia
+    int strassenLeaf = tuneStrassenLeafSize(*std::max_element(config.sizes.begin(), config.sizes.end()));
+
+    std::vector<Backend> backends;
+    backends.push_back({"binet", createBinet(64, parallelDepthFor(4, config.threads))});
+    backends.push_back({"strassen", createStrassen(strassenLeaf, parallelDepthFor(7, config.threads))});
+    backends.push_back({"winograd", createWinograd()});
+    backends.push_back({"gemm", createGemm()});
+    backends.push_back({"auto", createAuto("autotune.txt", config.threads)});
+
+    std::vector<BenchResult> results;
+    for (int n : config.sizes) {
+        // przekątna dominująca - rekurencyjne algorytmy nie pivotują
+        Matrix A = createRandomMatrix(n);
+        for (int i = 0; i < n; ++i) A[i][i] += n;
+        Matrix b = createRandomMatrix(n, 1);
+        double cube = static_cast<double>(n) * n * n;
+
+        for (Backend &backend : backends) {
+            auto inv = [&] { inverse(A, backend.impl); };
+            results.push_back(runBenchmark("inverse_" + backend.name, n, config, inv, countFlops(inv, 2.0 * cube)));
+
+            auto getri = [&] { inversePivoted(A, backend.impl); };
+            results.push_back(runBenchmark("inverse_pivoted_" + backend.name, n, config, getri,
+                                           countFlops(getri, 2.0 * cube)));
+
+            auto lu = [&] { LUfactorization(A, backend.impl); };
+            results.push_back(runBenchmark("lu_" + backend.name, n, config, lu, countFlops(lu, 2.0 / 3.0 * cube)));
+
+            auto getrf = [&] { LUfactorizationPivoted(A, backend.impl); };
+            results.push_back(runBenchmark("lu_pivoted_" + backend.name, n, config, getrf,
+                                           countFlops(getrf, 2.0 / 3.0 * cube)));
+
+            auto gauss = [&] { GaussElimination(A, b, backend.impl); };
+            results.push_back(runBenchmark("gauss_" + backend.name, n, config, gauss, countFlops(gauss, 2.0 / 3.0 * cube)));
+
+            // rozkład raz, potem tylko rozwiązania dla porcji 64 prawych stron
+            LUSolver solver(A, backend.impl);
+            Matrix rhs = createRandomMatrix(n, 64);
+            auto solve = [&] { solver.solve(rhs); };
+            results.push_back(runBenchmark("lu_solve64_" + backend.name, n, config, solve,
+                                           countFlops(solve, 2.0 * n * n * 64)));
+
+            // wersje kafelkowe - kernele na puli wątków według zależności (Tiled.h)
+            auto invTiled = [&] { inverseTiled(A, backend.impl); };
+            results.push_back(runBenchmark("inverse_tiled_" + backend.name, n, config, invTiled,
+                                           countFlops(invTiled, 2.0 * cube)));
+
+            auto luTiled = [&] { LUfactorizationTiled(A, backend.impl); };
+            results.push_back(runBenchmark("lu_tiled_" + backend.name, n, config, luTiled,
+                                           countFlops(luTiled, 2.0 / 3.0 * cube)));
+
+            auto gaussTiled = [&] { GaussEliminationTiled(A, b, backend.impl); };
+            results.push_back(runBenchmark("gauss_tiled_" + backend.name, n, config, gaussTiled,
+                                           countFlops(gaussTiled, 2.0 / 3.0 * cube)));
+        }
+    }
+
+    try {
+        writeBenchResults(config, results);
+    } catch (const std::exception &e) {
+        std::cerr << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
@@ -14,7 +14,21 @@
 #include "Strassen.h"
 #include "Inverse.h"
 #include "LUfactorization.h"
-#include "GaussElimination.h"
+#include "ThreadPool.h"
+#include "Auto.h"
+#include "PerfCounters.h"
+
+// 1-6: operacja (choice - 1) / 2 z Binetem (nieparzyste) albo Strassenem (parzyste),
+// 7-9: te same operacje z backendem dobieranym pod kształt przez createAuto
+static int operationOf(int choice) {
+    return choice > 6 ? choice - 7 : (choice - 1) / 2;
+}
+
+static std::unique_ptr<IMnozenie> backendFor(int choice, int threads, int leafSize = 64) {
+    if (choice > 6) return createAuto("autotune.txt", threads);
+    return choice % 2 == 1 ? createBinet(leafSize, parallelDepthFor(4, threads))
+                           : createStrassen(leafSize, parallelDepthFor(7, threads));
+}
 
 int main(int argc, char** argv) {
     if (argc >= 2) { //batch mode
@@ -57,15 +71,46 @@ int main(int argc, char** argv) {
 
         int choice = argv[1][0] - '0';
 
-        std::unique_ptr<IMnozenie> impl = choice % 2 == 1 ? createBinet() : createStrassen();
+        // Opcjonalny czwarty argument: rozmiar liścia rekurencji Bineta/Strassena
+        // (liczba albo "auto" - dobierany pomiarem), domyślnie 64
+        int leafSize = 64;
+        if (argc >= 5) {
+            std::string leaf = argv[4];
+            if (leaf == "auto") {
+                std::cout << "Tuning Strassen leaf size... ";
+                std::cout.flush();
+                leafSize = tuneStrassenLeafSize();
+                std::cout << leafSize << "\n";
+            } else {
+                try {
+                    leafSize = std::stoi(leaf);
+                } catch (...) {
+                    leafSize = 0;
+                }
+                if (leafSize < 1) {
+                    std::cerr << "Incorrect leaf size: " << leaf << "\n";
+                    return 1;
+                }
+            }
+        }
+
+        // Liczniki sprzętowe (MATRIX_PERF=1) otwierane przed utworzeniem puli,
+        // żeby obejmowały też wątki robocze
+        PerfCounters perf(perfCountersRequested());
+
+        // liczba wątków puli z MATRIX_THREADS (domyślnie liczba rdzeni)
+        int threads = threadPoolSize();
+        std::unique_ptr<IMnozenie> impl = backendFor(choice, threads, leafSize);
 
         std::ofstream out(outpath);
         if (!out.is_open()) {
             std::cerr << "Can't open results file\n";
             return 1;
         }
+        if (!instrumentationEnabled) std::cout << "(fast build - op and memory counters disabled)\n";
+        if (perfCountersRequested() && !perf.available()) std::cout << "(perf hardware counters unavailable - perf columns are \"-\")\n";
 
-        out << "# N time_s adds subs muls divs peak_bytes peak_calls\n";
+        out << "# N time_s adds subs muls divs peak_bytes peak_calls arena_peak_bytes alloc_peak_bytes alloc_count alloc_hist cycles instructions l1d_misses llc_misses fp_ops\n";
 
         for (size_t i = 0; i < sizes.size(); ++i) {
             int N = sizes[i];
@@ -79,31 +124,38 @@ int main(int argc, char** argv) {
 
             opCounterReset();
             memCounterReset();
+            perf.start();
             auto t0 = std::chrono::high_resolution_clock::now();
 
-            switch ((choice - 1) / 2)
+            switch (operationOf(choice))
             {
+            // losowa macierz nie ma przekątnej dominującej - odwrotność, LU
+            // i układ równań z wyborem elementu głównego
             case 0:
-                inverse(A, impl);
+                inversePivoted(A, impl);
                 break;
             case 1:
-                LUfactorization(A, impl);
+                LUfactorizationPivoted(A, impl);
                 break;
             case 2:
-                GaussElimination(A, b, impl);
+                LUSolver(A, impl).solve(b);
                 break;
             default:
                 break;
             }
             
             auto t1 = std::chrono::high_resolution_clock::now();
+            PerfSample ps = perf.stop();
             OpCounts ops = opCounterGet();
             MemStats ms = memCounterGet();
+            AllocStats as = allocCounterGet();
             std::chrono::duration<double> elapsed = t1 - t0;
 
             out << N << " " << std::fixed << std::setprecision(6) << elapsed.count()
                 << " " << ops.adds << " " << ops.subs << " " << ops.muls << " " << ops.divs
-                << " " << ms.peak_bytes << " " << ms.peak_calls << "\n";
+                << " " << ms.peak_bytes << " " << ms.peak_calls << " " << ms.arena_peak_bytes
+                << " " << as.peak_bytes << " " << as.alloc_count << " " << allocHistogramString(as)
+                << " " << perfSampleString(ps) << "\n";
             out.flush();
 
             std::cout << std::fixed << std::setprecision(3) << elapsed.count() << "s | ";
@@ -130,29 +182,37 @@ int main(int argc, char** argv) {
         std::cout << "4) Gauss elimination (Strassen)\n";
         std::cout << "5) LU factorization (Binet)\n";
         std::cout << "6) LU factorization (Strassen)\n";
+        std::cout << "7) Inverse matrix (auto-tuned backend)\n";
+        std::cout << "8) Gauss elimination (auto-tuned backend)\n";
+        std::cout << "9) LU factorization (auto-tuned backend)\n";
         std::cout << "Choice: ";
         if (!(std::cin >> choice)) choice = 1;
 
         Matrix A = createRandomMatrix(N);
-        std::unique_ptr<IMnozenie> impl = choice % 2 == 1 ? createBinet() : createStrassen();
+        int threads = threadPoolSize();
+        std::unique_ptr<IMnozenie> impl = backendFor(choice, threads);
 
-        switch ((choice - 1) / 2) {
+        switch (operationOf(choice)) {
             case 0: {
                 opCounterReset();
                 memCounterReset();
                 auto t0 = std::chrono::high_resolution_clock::now();
-                Matrix B = inverse(A, impl);
+                Matrix B = inversePivoted(A, impl);
                 auto t1 = std::chrono::high_resolution_clock::now();
                 OpCounts ops = opCounterGet();
                 MemStats ms = memCounterGet();
+                AllocStats as = allocCounterGet();
                 std::chrono::duration<double> elapsed = t1 - t0;
 
                 std::cout << "Time (s): " << std::fixed << std::setprecision(6) << elapsed.count() << "\n";
                 std::cout << "Op counts: adds=" << ops.adds << " subs=" << ops.subs
                             << " muls=" << ops.muls << " divs=" << ops.divs << "\n";
-                std::cout << "Memory (bytes): peak=" << ms.peak_bytes << " (peak calls=" << ms.peak_calls << ")\n";
+                std::cout << "Memory (bytes): peak=" << ms.peak_bytes << " (peak calls=" << ms.peak_calls << ")"
+                            << ", arena peak=" << ms.arena_peak_bytes << "\n";
+                std::cout << "Allocations: peak=" << as.peak_bytes << " count=" << as.alloc_count
+                            << " sizes(log2:count)=" << allocHistogramString(as) << "\n";
                 
-                B = inverse(A, impl);
+                B = inversePivoted(A, impl);
                 Matrix C = A * B;
                 auto [equal, max_err] = compareMatrices(C, identityMatrix(N), 1e-6);
                 if (equal) {
@@ -175,25 +235,35 @@ int main(int argc, char** argv) {
                 opCounterReset();
                 memCounterReset();
                 auto t0 = std::chrono::high_resolution_clock::now();
-                auto [C, c] = GaussElimination(A, b, impl);
+                // eliminacja z wyborem elementu głównego (rozkład P A = L U)
+                Matrix x = LUSolver(A, impl).solve(b);
                 auto t1 = std::chrono::high_resolution_clock::now();
                 OpCounts ops = opCounterGet();
                 MemStats ms = memCounterGet();
+                AllocStats as = allocCounterGet();
                 std::chrono::duration<double> elapsed = t1 - t0;
 
                 std::cout << "Time (s): " << std::fixed << std::setprecision(6) << elapsed.count() << "\n";
                 std::cout << "Op counts: adds=" << ops.adds << " subs=" << ops.subs
                             << " muls=" << ops.muls << " divs=" << ops.divs << "\n";
-                std::cout << "Memory (bytes): peak=" << ms.peak_bytes << " (peak calls=" << ms.peak_calls << ")\n";
+                std::cout << "Memory (bytes): peak=" << ms.peak_bytes << " (peak calls=" << ms.peak_calls << ")"
+                            << ", arena peak=" << ms.arena_peak_bytes << "\n";
+                std::cout << "Allocations: peak=" << as.peak_bytes << " count=" << as.alloc_count
+                            << " sizes(log2:count)=" << allocHistogramString(as) << "\n";
 
+                auto [solved, solve_err] = compareMatrices(impl->multiply(A, x), b, 1e-6);
+                if (solved) {
+                    std::cout << "Solve check passed (max error=" << std::setprecision(3) << solve_err << ")\n";
+                } else {
+                    std::cout << "Solve check FAILED (max error=" << std::setprecision(3) << solve_err << ")\n";
+                }
                 if (N <= 12) {
                     std::cout << "A:\n"; printSmall(A);
                     std::cout << "b:\n"; printSmall(b);
-                    std::cout << "C:\n"; printSmall(C);
-                    std::cout << "c:\n"; printSmall(c);
+                    std::cout << "x:\n"; printSmall(x);
                 } else {
-                    std::cout << "A[0][0] = " << std::setprecision(12) << A[0][0] << "\n";
-                    std::cout << "A[N-1][N-1] = " << A[N-1][N-1] << "\n";
+                    std::cout << "x[0] = " << std::setprecision(12) << x[0][0] << "\n";
+                    std::cout << "x[N-1] = " << x[N-1][0] << "\n";
                 }
                 break;
             }
@@ -201,31 +271,49 @@ int main(int argc, char** argv) {
                 opCounterReset();
                 memCounterReset();
                 auto t0 = std::chrono::high_resolution_clock::now();
-                auto [L, U] = LUfactorization(A, impl);
+                LUSolver solver(A, impl);
                 auto t1 = std::chrono::high_resolution_clock::now();
                 OpCounts ops = opCounterGet();
                 MemStats ms = memCounterGet();
+                AllocStats as = allocCounterGet();
                 std::chrono::duration<double> elapsed = t1 - t0;
 
                 std::cout << "Time (s): " << std::fixed << std::setprecision(6) << elapsed.count() << "\n";
                 std::cout << "Op counts: adds=" << ops.adds << " subs=" << ops.subs
                             << " muls=" << ops.muls << " divs=" << ops.divs << "\n";
-                std::cout << "Memory (bytes): peak=" << ms.peak_bytes << " (peak calls=" << ms.peak_calls << ")\n";
-                std::cout << "Determinant: " << determinantLU(A, impl) << "\n";
+                std::cout << "Memory (bytes): peak=" << ms.peak_bytes << " (peak calls=" << ms.peak_calls << ")"
+                            << ", arena peak=" << ms.arena_peak_bytes << "\n";
+                std::cout << "Allocations: peak=" << as.peak_bytes << " count=" << as.alloc_count
+                            << " sizes(log2:count)=" << allocHistogramString(as) << "\n";
+                std::cout << "Determinant: " << solver.determinant() << "\n";
 
+                // losowa macierz nie ma przekątnej dominującej - rozkład z wyborem
+                // elementu głównego, sprawdzenie L*U = P*A
+                auto [L, U] = unpackLU(solver.factors());
                 Matrix LU = impl->multiply(L, U);
-                auto [equal, max_err] = compareMatrices(LU, A, 1e-6);
+                Matrix PA = permuteRows(A, solver.pivots());
+                auto [equal, max_err] = compareMatrices(LU, PA, 1e-6);
                 if (equal) {
                     std::cout << "LU factorization check passed (max error=" << std::setprecision(3) << max_err << ")\n";
                 } else {
                     std::cout << "LU factorization check FAILED (max error=" << std::setprecision(3) << max_err << ")\n";
                 }
+
+                // ten sam rozkład dla kilku prawych stron naraz: A X = B
+                Matrix B = createRandomMatrix(N, 4);
+                Matrix X = solver.solve(B);
+                auto [solved, solve_err] = compareMatrices(impl->multiply(A, X), B, 1e-6);
+                if (solved) {
+                    std::cout << "Solve check passed (max error=" << std::setprecision(3) << solve_err << ")\n";
+                } else {
+                    std::cout << "Solve check FAILED (max error=" << std::setprecision(3) << solve_err << ")\n";
+                }
                 if (N <= 12) {
                     std::cout << "A:\n"; printSmall(A);
                     std::cout << "L:\n"; printSmall(L);
                     std::cout << "U:\n"; printSmall(U);
                     std::cout << "L*U:\n"; printSmall(LU);
-                    std::cout << "L*U - A:\n"; printSmall(LU - A);
+                    std::cout << "L*U - P*A:\n"; printSmall(LU - PA);
                 } else {
                     std::cout << "L[0][0] = " << std::setprecision(12) << L[0][0] << "\n";
                     std::cout << "U[N-1][N-1] = " << U[N-1][N-1] << "\n";
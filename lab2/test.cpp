@@ -0,0 +1,342 @@
+#include "SupportFunctions.h"
+#include "Auto.h"
+#include "BatchedGemm.h"
+#include "Binet.h"
+#include "GaussElimination.h"
+#include "Gemm.h"
+#include "Inverse.h"
+#include "LUfactorization.h"
+#include "Strassen.h"
+#include "ThreadPool.h"
+#include "Tiled.h"
+#include "Triangular.h"
+#include "Winograd.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// Test poprawności (make test). Mnożenie: każdy backend IMnozenie liczy
+// iloczyny kształtów nieparzystych, prostokątnych i niebędących potęgami
+// dwójki, porównywane z naiwnym iloczynem (operator*). Błąd względny:
+// max |C - C_ref| / (k * max|A| * max|B|). Rozkłady i układy równań:
+// residua L*U - P*A, A*inv(A) - I i A*X - B z tą samą normalizacją (iloczyn
+// liczony naiwnie, niezależnie od backendu), dla rozmiarów nieparzystych
+// i niebędących potęgami dwójki, każdym backendem. Kod wyjścia 1, gdy któryś
+// przypadek przekroczy tolerancję.
+
+namespace {
+
+// Strassen/Winograd gubią kilka cyfr na poziom rekurencji - zapas na ~5 poziomów
+constexpr double kProductTol = 1e-10;
+// residua rozkładów z wyborem elementu głównego (losowe macierze, mały wzrost)
+constexpr double kSolveTol = 1e-12;
+
+struct Shape {
+    int m, k, n;
+};
+
+const std::vector<Shape> kShapes = {
+    {1, 1, 1},    {2, 3, 4},     {5, 7, 3},      {17, 17, 17},   {31, 64, 33},    {64, 64, 64},
+    {65, 65, 65}, {100, 37, 129}, {129, 200, 70}, {200, 3, 150}, {255, 256, 257}, {300, 300, 300},
+};
+
+int failures = 0;
+
+double maxAbs(ConstMatrixView X) {
+    double m = 0.0;
+    for (int i = 0; i < X.rows; ++i)
+        for (int j = 0; j < X.cols; ++j) m = std::max(m, std::fabs(X[i][j]));
+    return m;
+}
+
+double maxDiff(ConstMatrixView X, ConstMatrixView Y) {
+    double m = 0.0;
+    for (int i = 0; i < X.rows; ++i)
+        for (int j = 0; j < X.cols; ++j) m = std::max(m, std::fabs(X[i][j] - Y[i][j]));
+    return m;
+}
+
+double productError(ConstMatrixView C, ConstMatrixView ref, ConstMatrixView A, ConstMatrixView B) {
+    double scale = std::max(1, A.cols) * maxAbs(A) * maxAbs(B);
+    return maxDiff(C, ref) / (scale > 0.0 ? scale : 1.0);
+}
+
+// Wypisuje tylko przypadki poza tolerancją (NaN też); zwraca błąd
+double check(const std::string &what, double err, double tol) {
+    if (!(err <= tol)) {
+        ++failures;
+        std::cout << "  BŁĄD " << what << ": błąd względny " << std::scientific << std::setprecision(2) << err
+                  << std::defaultfloat << "\n";
+    }
+    return err;
+}
+
+// Największy błąd względny grupy przypadków
+void report(const std::string &name, double worst) {
+    std::cout << "  " << std::scientific << std::setprecision(2) << worst << std::defaultfloat << "  " << name
+              << "\n";
+}
+
+std::string shapeName(const Shape &s) {
+    return std::to_string(s.m) + "x" + std::to_string(s.k) + "*" + std::to_string(s.k) + "x" + std::to_string(s.n);
+}
+
+// multiplyInto oraz multiplyAdd z transpozycjami (C = 2 A^T B^T - C) dla wszystkich kształtów
+void testBackend(const std::string &name, IMnozenie &impl, const std::vector<Shape> &shapes) {
+    double worst = 0.0;
+    for (const Shape &s : shapes) {
+        Matrix A = createRandomMatrix(s.m, s.k), B = createRandomMatrix(s.k, s.n);
+        Matrix ref = A * B;
+        worst = std::max(worst, check(name + " " + shapeName(s), productError(impl.multiply(A, B), ref, A, B),
+                                      kProductTol));
+
+        Matrix At = zeroMatrix(s.k, s.m), Bt = zeroMatrix(s.n, s.k);
+        transposeInto(A, At);
+        transposeInto(B, Bt);
+        Matrix C = createRandomMatrix(s.m, s.n), expected = zeroMatrix(s.m, s.n);
+        for (int i = 0; i < s.m; ++i)
+            for (int j = 0; j < s.n; ++j) expected[i][j] = 2.0 * ref[i][j] - C[i][j];
+        impl.multiplyAdd(C, 2.0, At, Bt, -1.0, Op::Trans, Op::Trans);
+        worst = std::max(worst, check(name + " multiplyAdd " + shapeName(s), productError(C, expected, A, B) / 2.0,
+                                      kProductTol));
+    }
+    report(name, worst);
+}
+
+void testBatched() {
+    double worst = 0.0;
+    for (int s = 1; s <= kSmallGemmMax; ++s) {
+        for (int count : {1, 3, 8, 21}) {
+            std::vector<Matrix> A, B, C;
+            for (int i = 0; i < count; ++i) {
+                A.push_back(createRandomMatrix(s, s + 1));
+                B.push_back(createRandomMatrix(s + 1, s));
+                C.push_back(zeroMatrix(s, s));
+            }
+            std::vector<ConstMatrixView> a(A.begin(), A.end()), b(B.begin(), B.end());
+            std::vector<MatrixView> c(C.begin(), C.end());
+            gemmBatched(count, a.data(), b.data(), c.data());
+            for (int i = 0; i < count; ++i) {
+                worst = std::max(worst, check("gemmBatched " + std::to_string(s) + " x" + std::to_string(count),
+                                              productError(C[i], A[i] * B[i], A[i], B[i]), kProductTol));
+            }
+        }
+    }
+    report("gemmBatched", worst);
+}
+
+struct Backend {
+    std::string name;
+    std::unique_ptr<IMnozenie> impl;
+};
+
+// Backendy dla rozkładów, z głębokością zrównoleglenia pod pulę threads
+std::vector<Backend> backends(int threads) {
+    std::vector<Backend> list;
+    list.push_back({"gemm", createGemm()});
+    list.push_back({"binet", createBinet(16, parallelDepthFor(4, threads))});
+    list.push_back({"strassen", createStrassen(16, parallelDepthFor(7, threads))});
+    list.push_back({"winograd", createWinograd(16)});
+    list.push_back({"auto", createAuto("", threads)});
+    return list;
+}
+
+std::string threadsName(int threads) {
+    return threads == 1 ? "" : " (" + std::to_string(threads) + " wątki)";
+}
+
+// L*U == P*A z wyniku rozkładu (spakowane L i U, piv)
+double luError(const Matrix &A, const Matrix &LU, const std::vector<int> &piv) {
+    auto [L, U] = unpackLU(LU);
+    return productError(L * U, permuteRows(A, piv), L, U);
+}
+
+// A*X == B
+double solveError(const Matrix &A, const Matrix &X, const Matrix &B) {
+    return productError(A * X, B, A, X);
+}
+
+const std::vector<int> kSizes = {1, 2, 7, 31, 64, 65, 100, 129, 257, 300};
+
+// Kafelkowe LU, Gauss i odwracanie (Tiled.h) dla kilku rozmiarów kafelka,
+// także niedzielących n
+void testTiled(std::vector<Backend> &list, int threads) {
+    for (Backend &b : list) {
+        double worst = 0.0;
+        for (int n : kSizes) {
+            for (int ts : {4, 16, 48, kTileSize}) {
+                if (n / ts > 40) continue; // zbyt wiele drobnych zadań
+                std::string what = b.name + " n=" + std::to_string(n) + " ts=" + std::to_string(ts);
+                Matrix A = createRandomMatrix(n), B = createRandomMatrix(n, 3);
+
+                auto [LU, piv] = LUfactorizationTiled(A, b.impl, ts);
+                worst = std::max(worst, check("LUfactorizationTiled " + what, luError(A, LU, piv), kSolveTol));
+
+                auto [C, c] = GaussEliminationTiled(A, B, b.impl, ts);
+                trsm(Side::Left, Uplo::Upper, Diag::NonUnit, C, c, *b.impl);
+                worst = std::max(worst, check("GaussEliminationTiled " + what, solveError(A, c, B), kSolveTol));
+
+                Matrix X = inverseTiled(A, b.impl, ts);
+                worst = std::max(worst,
+                                 check("inverseTiled " + what, solveError(A, X, identityMatrix(n)), kSolveTol));
+            }
+        }
+        report("kafelkowe LU/Gauss/inverse, " + b.name + threadsName(threads), worst);
+    }
+}
+
+// det(P L0 U0) = -prod diag(U0): L0 z jedynkami na przekątnej, jedna zamiana wierszy
+std::pair<Matrix, double> matrixWithDeterminant(int n) {
+    Matrix L0 = createRandomMatrix(n), U0 = createRandomMatrix(n);
+    double det = 1.0;
+    for (int i = 0; i < n; ++i) {
+        for (int j = 0; j < n; ++j) {
+            if (j > i) L0[i][j] = 0.0;
+            if (j < i) U0[i][j] = 0.0;
+            if (j != i) L0[i][j] /= n;
+        }
+        L0[i][i] = 1.0;
+        U0[i][i] += 1.0;
+        det *= U0[i][i];
+    }
+    Matrix A = L0 * U0;
+    if (n < 2) return {A, det};
+    std::swap_ranges(A[0], A[0] + n, A[n - 1]);
+    return {A, -det};
+}
+
+// LUSolver (rozkład raz, wiele prawych stron), LUfactorizationPivoted i inversePivoted
+void testSolver(std::vector<Backend> &list, int threads) {
+    for (Backend &b : list) {
+        double worst = 0.0;
+        for (int n : kSizes) {
+            std::string what = b.name + " n=" + std::to_string(n);
+            Matrix A = createRandomMatrix(n);
+
+            auto [LU, piv] = LUfactorizationPivoted(A, b.impl);
+            worst = std::max(worst, check("LUfactorizationPivoted " + what, luError(A, LU, piv), kSolveTol));
+
+            LUSolver solver(A, b.impl);
+            worst = std::max(worst, check("LUSolver factors " + what,
+                                          luError(A, solver.factors(), solver.pivots()), kSolveTol));
+            for (int k : {1, 3, 17}) {
+                Matrix B = createRandomMatrix(n, k);
+                worst = std::max(worst, check("LUSolver::solve k=" + std::to_string(k) + " " + what,
+                                              solveError(A, solver.solve(B), B), kSolveTol));
+            }
+            // solveInto na bloku większej macierzy (ld > liczby kolumn)
+            Matrix big = createRandomMatrix(n + 2, 9);
+            Matrix B = subMatrix(big, 1, 2, n, 5);
+            solver.solveInto(MatrixView(big).block(1, 2, n, 5));
+            worst = std::max(worst, check("LUSolver::solveInto " + what, solveError(A, subMatrix(big, 1, 2, n, 5), B),
+                                          kSolveTol));
+
+            worst = std::max(worst, check("inversePivoted " + what,
+                                          solveError(A, inversePivoted(A, b.impl), identityMatrix(n)), kSolveTol));
+
+            auto [D, det] = matrixWithDeterminant(n);
+            worst = std::max(worst, check("LUSolver::determinant " + what,
+                                          std::fabs(LUSolver(D, b.impl).determinant() - det) / std::fabs(det),
+                                          kSolveTol * n));
+        }
+        report("LUSolver/getrf/inverse, " + b.name + threadsName(threads), worst);
+    }
+}
+
+// determinantLU: 0 tylko dla macierzy osobliwej, macierz niekwadratowa - wyjątek
+void testDeterminantErrors() {
+    std::unique_ptr<IMnozenie> impl = createGemm();
+    // zerowa kolumna daje dokładnie zerowy element główny (powtórzony wiersz
+    // - nie zawsze, przez zaokrąglenia)
+    Matrix S = createRandomMatrix(5);
+    for (int i = 0; i < 5; ++i) S[i][2] = 0.0;
+    if (determinantLU(S, impl) != 0.0) {
+        ++failures;
+        std::cout << "  BŁĄD determinantLU macierzy osobliwej różny od 0\n";
+    }
+    bool rejected = false;
+    try {
+        determinantLU(createRandomMatrix(4, 5), impl);
+    } catch (const std::runtime_error &) {
+        rejected = true;
+    }
+    if (!rejected) {
+        ++failures;
+        std::cout << "  BŁĄD determinantLU przyjął macierz 4x5\n";
+    }
+}
+
+// Rekurencyjne inverse, LUfactorization i GaussElimination bez wyboru elementu
+// głównego - macierz z przekątną dominującą; rozmiary 2^k +- 1 dzielone
+// nierówno na każdym poziomie
+void testRecursive(std::vector<Backend> &list, int threads) {
+    std::vector<int> sizes = kSizes;
+    sizes.insert(sizes.end(), {3, 5, 9, 17, 33, 63, 127});
+    for (Backend &b : list) {
+        double worst = 0.0;
+        for (int n : sizes) {
+            std::string what = b.name + " n=" + std::to_string(n);
+            Matrix A = createRandomMatrix(n);
+            for (int i = 0; i < n; ++i) A[i][i] += n;
+
+            worst = std::max(worst, check("inverse " + what, solveError(A, inverse(A, b.impl), identityMatrix(n)),
+                                          kSolveTol));
+
+            auto [L, U] = LUfactorization(A, b.impl);
+            worst = std::max(worst, check("LUfactorization " + what, productError(L * U, A, L, U), kSolveTol));
+
+            for (int k : {1, 3}) {
+                Matrix B = createRandomMatrix(n, k);
+                auto [C, c] = GaussElimination(A, B, b.impl);
+                trsm(Side::Left, Uplo::Upper, Diag::NonUnit, C, c, *b.impl);
+                worst = std::max(worst, check("GaussElimination k=" + std::to_string(k) + " " + what,
+                                              solveError(A, c, B), kSolveTol));
+            }
+        }
+        report("rekurencyjne inverse/LU/Gauss, " + b.name + threadsName(threads), worst);
+    }
+}
+
+} // namespace
+
+int main() {
+    std::cout << "=== Mnożenie: backendy IMnozenie vs iloczyn naiwny ===" << std::endl;
+
+    // mały liść, żeby rekurencja miała kilka poziomów także dla małych kształtów
+    threadPoolSetSize(1);
+    testBackend("gemm", *createGemm(), kShapes);
+    testBackend("binet", *createBinet(16, 0), kShapes);
+    testBackend("strassen", *createStrassen(16, 0), kShapes);
+    testBackend("winograd", *createWinograd(16), kShapes);
+    testBackend("auto", *createAuto("", 1), kShapes);
+
+    // wersje równoległe na wspólnej puli
+    threadPoolSetSize(4);
+    testBackend("binet (4 wątki)", *createBinet(16, parallelDepthFor(4, 4)), kShapes);
+    testBackend("strassen (4 wątki)", *createStrassen(16, parallelDepthFor(7, 4)), kShapes);
+    testBackend("auto (4 wątki)", *createAuto("", 4), kShapes);
+    threadPoolSetSize(1);
+
+    testBatched();
+
+    std::cout << "=== Rozkłady i układy równań: residua ===" << std::endl;
+    for (int threads : {1, 4}) {
+        threadPoolSetSize(threads);
+        std::vector<Backend> list = backends(threads);
+        testTiled(list, threads);
+        testSolver(list, threads);
+        testRecursive(list, threads);
+    }
+    threadPoolSetSize(1);
+    testDeterminantErrors();
+
+    std::cout << (failures == 0 ? "Wszystkie testy przeszły" : "Nieudane testy: " + std::to_string(failures))
+              << std::endl;
+    return failures == 0 ? 0 : 1;
+}
@@ -7,7 +7,7 @@ TreeNode* createTree(const Matrix &A, int rank, double epsilon) {
     if (static_cast<int>(D.size()) < rank || D[rank - 1] < epsilon) {
         if (allclose_zero(A, 1e-10)) {
             TreeNode* node = new TreeNode();
-            node->singularValues = zeroMatrix(1, rank)[0];
+            node->singularValues = Vector(rank, 0.0);
             node->U = zeroMatrix(rows(A), rank);
             node->V = zeroMatrix(rank, cols(A));
             return node;
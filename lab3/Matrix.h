@@ -0,0 +1,61 @@
+#pragma once
+#include <vector>
+#include <cstddef>
+#include <initializer_list>
+
+/**
+ * Gęsta macierz w układzie row-major trzymana w jednym, ciągłym buforze.
+ *
+ * Element (i, j) leży pod data()[i * ld() + j]. Leading dimension ld() >= cols()
+ * pozwala wyrównać wiersze (np. do szerokości wektora SIMD) bez zmiany logicznego
+ * rozmiaru. M[i] zwraca wskaźnik na początek wiersza, więc zapis M[i][j] działa
+ * tak jak przy dawnym vector<vector<double>>, ale bez osobnej alokacji na wiersz.
+ */
+class Matrix {
+public:
+    Matrix() = default;
+
+    Matrix(int rows, int cols, double value = 0.0)
+        : Matrix(rows, cols, cols, value) {}
+
+    Matrix(int rows, int cols, int ld, double value)
+        : rows_(rows), cols_(cols), ld_(ld < cols ? cols : ld),
+          buf_(static_cast<std::size_t>(rows) * static_cast<std::size_t>(ld_), value) {}
+
+    Matrix(std::initializer_list<std::initializer_list<double>> init)
+        : Matrix(static_cast<int>(init.size()),
+                 init.size() ? static_cast<int>(init.begin()->size()) : 0) {
+        int i = 0;
+        for (const auto &row : init) {
+            int j = 0;
+            for (double v : row) {
+                if (j < cols_) (*this)[i][j] = v;
+                ++j;
+            }
+            ++i;
+        }
+    }
+
+    int rows() const { return rows_; }
+    int cols() const { return cols_; }
+    int ld() const { return ld_; }
+    bool empty() const { return rows_ == 0 || cols_ == 0; }
+
+    double *data() { return buf_.data(); }
+    const double *data() const { return buf_.data(); }
+
+    double *operator[](int i) { return buf_.data() + static_cast<std::size_t>(i) * ld_; }
+    const double *operator[](int i) const { return buf_.data() + static_cast<std::size_t>(i) * ld_; }
+
+    double &operator()(int i, int j) { return (*this)[i][j]; }
+    double operator()(int i, int j) const { return (*this)[i][j]; }
+
+private:
+    int rows_ = 0;
+    int cols_ = 0;
+    int ld_ = 0;
+    std::vector<double> buf_;
+};
+
+inline int rows(const Matrix &M) { return M.rows(); }
+inline int cols(const Matrix &M) { return M.cols(); }
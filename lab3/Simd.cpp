@@ -0,0 +1,305 @@
+#include "Simd.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <immintrin.h>
+
+#define SIMD_AVX2 __attribute__((target("avx2,fma")))
+#define SIMD_AVX512 __attribute__((target("avx512f")))
+
+namespace {
+
+// ---------------------------------------------------------------------------
+// Scalar fallback
+// ---------------------------------------------------------------------------
+
+double dotScalar(int n, const double *x, const double *y) {
+    double s0 = 0.0, s1 = 0.0, s2 = 0.0, s3 = 0.0;
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        s0 += x[i] * y[i];
+        s1 += x[i + 1] * y[i + 1];
+        s2 += x[i + 2] * y[i + 2];
+        s3 += x[i + 3] * y[i + 3];
+    }
+    for (; i < n; ++i) s0 += x[i] * y[i];
+    return (s0 + s1) + (s2 + s3);
+}
+
+void axpyScalar(int n, double alpha, const double *x, double *y) {
+    for (int i = 0; i < n; ++i) y[i] += alpha * x[i];
+}
+
+void addScalar(int n, const double *x, const double *y, double *z) {
+    for (int i = 0; i < n; ++i) z[i] = x[i] + y[i];
+}
+
+void subScalar(int n, const double *x, const double *y, double *z) {
+    for (int i = 0; i < n; ++i) z[i] = x[i] - y[i];
+}
+
+// y += a0 * x0 + a1 * x1 + a2 * x2 + a3 * x3 (four rows at a time for the Gram product)
+void axpy4Scalar(int n, const double *a, const double *const *x, double *y) {
+    for (int i = 0; i < n; ++i)
+        y[i] += a[0] * x[0][i] + a[1] * x[1][i] + a[2] * x[2][i] + a[3] * x[3][i];
+}
+
+// ---------------------------------------------------------------------------
+// AVX2 + FMA (4 x double)
+// ---------------------------------------------------------------------------
+
+SIMD_AVX2 double hsum256(__m256d v) {
+    __m128d lo = _mm256_castpd256_pd128(v);
+    __m128d hi = _mm256_extractf128_pd(v, 1);
+    lo = _mm_add_pd(lo, hi);
+    return _mm_cvtsd_f64(_mm_add_sd(lo, _mm_unpackhi_pd(lo, lo)));
+}
+
+SIMD_AVX2 double dotAvx2(int n, const double *x, const double *y) {
+    __m256d s0 = _mm256_setzero_pd(), s1 = _mm256_setzero_pd();
+    __m256d s2 = _mm256_setzero_pd(), s3 = _mm256_setzero_pd();
+    int i = 0;
+    for (; i + 16 <= n; i += 16) {
+        s0 = _mm256_fmadd_pd(_mm256_loadu_pd(x + i), _mm256_loadu_pd(y + i), s0);
+        s1 = _mm256_fmadd_pd(_mm256_loadu_pd(x + i + 4), _mm256_loadu_pd(y + i + 4), s1);
+        s2 = _mm256_fmadd_pd(_mm256_loadu_pd(x + i + 8), _mm256_loadu_pd(y + i + 8), s2);
+        s3 = _mm256_fmadd_pd(_mm256_loadu_pd(x + i + 12), _mm256_loadu_pd(y + i + 12), s3);
+    }
+    for (; i + 4 <= n; i += 4)
+        s0 = _mm256_fmadd_pd(_mm256_loadu_pd(x + i), _mm256_loadu_pd(y + i), s0);
+    double s = hsum256(_mm256_add_pd(_mm256_add_pd(s0, s1), _mm256_add_pd(s2, s3)));
+    for (; i < n; ++i) s += x[i] * y[i];
+    return s;
+}
+
+SIMD_AVX2 void axpyAvx2(int n, double alpha, const double *x, double *y) {
+    __m256d a = _mm256_set1_pd(alpha);
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        _mm256_storeu_pd(y + i, _mm256_fmadd_pd(a, _mm256_loadu_pd(x + i), _mm256_loadu_pd(y + i)));
+        _mm256_storeu_pd(y + i + 4, _mm256_fmadd_pd(a, _mm256_loadu_pd(x + i + 4), _mm256_loadu_pd(y + i + 4)));
+    }
+    for (; i + 4 <= n; i += 4)
+        _mm256_storeu_pd(y + i, _mm256_fmadd_pd(a, _mm256_loadu_pd(x + i), _mm256_loadu_pd(y + i)));
+    for (; i < n; ++i) y[i] += alpha * x[i];
+}
+
+SIMD_AVX2 void addAvx2(int n, const double *x, const double *y, double *z) {
+    int i = 0;
+    for (; i + 4 <= n; i += 4)
+        _mm256_storeu_pd(z + i, _mm256_add_pd(_mm256_loadu_pd(x + i), _mm256_loadu_pd(y + i)));
+    for (; i < n; ++i) z[i] = x[i] + y[i];
+}
+
+SIMD_AVX2 void subAvx2(int n, const double *x, const double *y, double *z) {
+    int i = 0;
+    for (; i + 4 <= n; i += 4)
+        _mm256_storeu_pd(z + i, _mm256_sub_pd(_mm256_loadu_pd(x + i), _mm256_loadu_pd(y + i)));
+    for (; i < n; ++i) z[i] = x[i] - y[i];
+}
+
+SIMD_AVX2 void axpy4Avx2(int n, const double *a, const double *const *x, double *y) {
+    __m256d a0 = _mm256_set1_pd(a[0]), a1 = _mm256_set1_pd(a[1]);
+    __m256d a2 = _mm256_set1_pd(a[2]), a3 = _mm256_set1_pd(a[3]);
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256d v = _mm256_loadu_pd(y + i);
+        v = _mm256_fmadd_pd(a0, _mm256_loadu_pd(x[0] + i), v);
+        v = _mm256_fmadd_pd(a1, _mm256_loadu_pd(x[1] + i), v);
+        v = _mm256_fmadd_pd(a2, _mm256_loadu_pd(x[2] + i), v);
+        v = _mm256_fmadd_pd(a3, _mm256_loadu_pd(x[3] + i), v);
+        _mm256_storeu_pd(y + i, v);
+    }
+    for (; i < n; ++i)
+        y[i] += a[0] * x[0][i] + a[1] * x[1][i] + a[2] * x[2][i] + a[3] * x[3][i];
+}
+
+// ---------------------------------------------------------------------------
+// AVX-512 (8 x double)
+// ---------------------------------------------------------------------------
+
+SIMD_AVX512 double dotAvx512(int n, const double *x, const double *y) {
+    __m512d s0 = _mm512_setzero_pd(), s1 = _mm512_setzero_pd();
+    __m512d s2 = _mm512_setzero_pd(), s3 = _mm512_setzero_pd();
+    int i = 0;
+    for (; i + 32 <= n; i += 32) {
+        s0 = _mm512_fmadd_pd(_mm512_loadu_pd(x + i), _mm512_loadu_pd(y + i), s0);
+        s1 = _mm512_fmadd_pd(_mm512_loadu_pd(x + i + 8), _mm512_loadu_pd(y + i + 8), s1);
+        s2 = _mm512_fmadd_pd(_mm512_loadu_pd(x + i + 16), _mm512_loadu_pd(y + i + 16), s2);
+        s3 = _mm512_fmadd_pd(_mm512_loadu_pd(x + i + 24), _mm512_loadu_pd(y + i + 24), s3);
+    }
+    for (; i + 8 <= n; i += 8)
+        s0 = _mm512_fmadd_pd(_mm512_loadu_pd(x + i), _mm512_loadu_pd(y + i), s0);
+    if (i < n) {
+        __mmask8 m = static_cast<__mmask8>((1u << (n - i)) - 1);
+        s1 = _mm512_fmadd_pd(_mm512_maskz_loadu_pd(m, x + i), _mm512_maskz_loadu_pd(m, y + i), s1);
+    }
+    double t[8];
+    _mm512_storeu_pd(t, _mm512_add_pd(_mm512_add_pd(s0, s1), _mm512_add_pd(s2, s3)));
+    return ((t[0] + t[1]) + (t[2] + t[3])) + ((t[4] + t[5]) + (t[6] + t[7]));
+}
+
+SIMD_AVX512 void axpyAvx512(int n, double alpha, const double *x, double *y) {
+    __m512d a = _mm512_set1_pd(alpha);
+    int i = 0;
+    for (; i + 16 <= n; i += 16) {
+        _mm512_storeu_pd(y + i, _mm512_fmadd_pd(a, _mm512_loadu_pd(x + i), _mm512_loadu_pd(y + i)));
+        _mm512_storeu_pd(y + i + 8, _mm512_fmadd_pd(a, _mm512_loadu_pd(x + i + 8), _mm512_loadu_pd(y + i + 8)));
+    }
+    for (; i + 8 <= n; i += 8)
+        _mm512_storeu_pd(y + i, _mm512_fmadd_pd(a, _mm512_loadu_pd(x + i), _mm512_loadu_pd(y + i)));
+    if (i < n) {
+        __mmask8 m = static_cast<__mmask8>((1u << (n - i)) - 1);
+        __m512d v = _mm512_fmadd_pd(a, _mm512_maskz_loadu_pd(m, x + i), _mm512_maskz_loadu_pd(m, y + i));
+        _mm512_mask_storeu_pd(y + i, m, v);
+    }
+}
+
+SIMD_AVX512 void addAvx512(int n, const double *x, const double *y, double *z) {
+    int i = 0;
+    for (; i + 8 <= n; i += 8)
+        _mm512_storeu_pd(z + i, _mm512_add_pd(_mm512_loadu_pd(x + i), _mm512_loadu_pd(y + i)));
+    if (i < n) {
+        __mmask8 m = static_cast<__mmask8>((1u << (n - i)) - 1);
+        _mm512_mask_storeu_pd(z + i, m, _mm512_add_pd(_mm512_maskz_loadu_pd(m, x + i), _mm512_maskz_loadu_pd(m, y + i)));
+    }
+}
+
+SIMD_AVX512 void subAvx512(int n, const double *x, const double *y, double *z) {
+    int i = 0;
+    for (; i + 8 <= n; i += 8)
+        _mm512_storeu_pd(z + i, _mm512_sub_pd(_mm512_loadu_pd(x + i), _mm512_loadu_pd(y + i)));
+    if (i < n) {
+        __mmask8 m = static_cast<__mmask8>((1u << (n - i)) - 1);
+        _mm512_mask_storeu_pd(z + i, m, _mm512_sub_pd(_mm512_maskz_loadu_pd(m, x + i), _mm512_maskz_loadu_pd(m, y + i)));
+    }
+}
+
+SIMD_AVX512 void axpy4Avx512(int n, const double *a, const double *const *x, double *y) {
+    __m512d a0 = _mm512_set1_pd(a[0]), a1 = _mm512_set1_pd(a[1]);
+    __m512d a2 = _mm512_set1_pd(a[2]), a3 = _mm512_set1_pd(a[3]);
+    int i = 0;
+    for (; i < n; i += 8) {
+        __mmask8 m = n - i >= 8 ? static_cast<__mmask8>(0xFF) : static_cast<__mmask8>((1u << (n - i)) - 1);
+        __m512d v = _mm512_maskz_loadu_pd(m, y + i);
+        v = _mm512_fmadd_pd(a0, _mm512_maskz_loadu_pd(m, x[0] + i), v);
+        v = _mm512_fmadd_pd(a1, _mm512_maskz_loadu_pd(m, x[1] + i), v);
+        v = _mm512_fmadd_pd(a2, _mm512_maskz_loadu_pd(m, x[2] + i), v);
+        v = _mm512_fmadd_pd(a3, _mm512_maskz_loadu_pd(m, x[3] + i), v);
+        _mm512_mask_storeu_pd(y + i, m, v);
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Kernel selection
+// ---------------------------------------------------------------------------
+
+struct Kernels {
+    SimdIsa isa;
+    double (*dot)(int, const double *, const double *);
+    void (*axpy)(int, double, const double *, double *);
+    void (*add)(int, const double *, const double *, double *);
+    void (*sub)(int, const double *, const double *, double *);
+    void (*axpy4)(int, const double *, const double *const *, double *);
+};
+
+const Kernels scalarKernels = {SimdIsa::Scalar, dotScalar, axpyScalar, addScalar, subScalar, axpy4Scalar};
+const Kernels avx2Kernels = {SimdIsa::Avx2, dotAvx2, axpyAvx2, addAvx2, subAvx2, axpy4Avx2};
+const Kernels avx512Kernels = {SimdIsa::Avx512, dotAvx512, axpyAvx512, addAvx512, subAvx512, axpy4Avx512};
+
+const Kernels &selectKernels() {
+    __builtin_cpu_init();
+    SimdIsa best = SimdIsa::Scalar;
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) best = SimdIsa::Avx2;
+    if (__builtin_cpu_supports("avx512f")) best = SimdIsa::Avx512;
+
+    // MATRIX_SIMD can only lower the level - it never enables instructions the CPU lacks
+    if (const char *env = std::getenv("MATRIX_SIMD")) {
+        SimdIsa wanted = best;
+        if (std::strcmp(env, "scalar") == 0) wanted = SimdIsa::Scalar;
+        else if (std::strcmp(env, "avx2") == 0) wanted = SimdIsa::Avx2;
+        else if (std::strcmp(env, "avx512") == 0) wanted = SimdIsa::Avx512;
+        best = std::min(best, wanted);
+    }
+
+    switch (best) {
+        case SimdIsa::Avx512: return avx512Kernels;
+        case SimdIsa::Avx2: return avx2Kernels;
+        default: return scalarKernels;
+    }
+}
+
+const Kernels &kernels() {
+    static const Kernels &k = selectKernels();
+    return k;
+}
+
+} // namespace
+
+SimdIsa simdIsa() {
+    return kernels().isa;
+}
+
+const char *simdIsaName(SimdIsa isa) {
+    switch (isa) {
+        case SimdIsa::Avx512: return "avx512";
+        case SimdIsa::Avx2: return "avx2";
+        default: return "scalar";
+    }
+}
+
+double simdDot(int n, const double *x, const double *y) {
+    return kernels().dot(n, x, y);
+}
+
+void simdAxpy(int n, double alpha, const double *x, double *y) {
+    kernels().axpy(n, alpha, x, y);
+}
+
+void simdAdd(int n, const double *x, const double *y, double *z) {
+    kernels().add(n, x, y, z);
+}
+
+void simdSub(int n, const double *x, const double *y, double *z) {
+    kernels().sub(n, x, y, z);
+}
+
+void simdGemv(int m, int n, const double *A, int lda, const double *x, double *y) {
+    const Kernels &k = kernels();
+    for (int i = 0; i < m; ++i)
+        y[i] = k.dot(n, A + static_cast<std::size_t>(i) * lda, x);
+}
+
+// G = A^T * A as a sum of rank-4 updates (four rows of A at a time), upper
+// triangle only, in row blocks of G small enough to stay in cache. The lower
+// triangle is mirrored at the end.
+void simdGram(int m, int n, const double *A, int lda, double *G, int ldg) {
+    const Kernels &k = kernels();
+    for (int i = 0; i < n; ++i)
+        std::fill(G + static_cast<std::size_t>(i) * ldg + i, G + static_cast<std::size_t>(i) * ldg + n, 0.0);
+
+    const int rowBlock = 32;
+    for (int i0 = 0; i0 < n; i0 += rowBlock) {
+        int i1 = std::min(n, i0 + rowBlock);
+        int r = 0;
+        for (; r + 4 <= m; r += 4) {
+            const double *x[4];
+            for (int t = 0; t < 4; ++t) x[t] = A + static_cast<std::size_t>(r + t) * lda;
+            for (int i = i0; i < i1; ++i) {
+                const double a[4] = {x[0][i], x[1][i], x[2][i], x[3][i]};
+                const double *xi[4] = {x[0] + i, x[1] + i, x[2] + i, x[3] + i};
+                k.axpy4(n - i, a, xi, G + static_cast<std::size_t>(i) * ldg + i);
+            }
+        }
+        for (; r < m; ++r) {
+            const double *Ar = A + static_cast<std::size_t>(r) * lda;
+            for (int i = i0; i < i1; ++i)
+                k.axpy(n - i, Ar[i], Ar + i, G + static_cast<std::size_t>(i) * ldg + i);
+        }
+    }
+
+    for (int i = 0; i < n; ++i)
+        for (int j = 0; j < i; ++j)
+            G[static_cast<std::size_t>(i) * ldg + j] = G[static_cast<std::size_t>(j) * ldg + i];
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+/**
+ * Vector kernels (AVX2 / AVX-512) with a scalar fallback.
+ *
+ * The instruction set is picked once, on first use, from cpuid
+ * (__builtin_cpu_supports), so the same binary runs on AVX2-only and on
+ * AVX-512 machines. The MATRIX_SIMD=scalar|avx2|avx512 environment variable
+ * forces a weaker variant (e.g. for comparisons).
+ *
+ * The functions work on raw pointers and do not count operations.
+ */
+enum class SimdIsa { Scalar, Avx2, Avx512 };
+
+SimdIsa simdIsa();
+const char *simdIsaName(SimdIsa isa);
+
+double simdDot(int n, const double *x, const double *y);                       // x . y
+void simdAxpy(int n, double alpha, const double *x, double *y);                // y += alpha * x
+void simdAdd(int n, const double *x, const double *y, double *z);              // z = x + y
+void simdSub(int n, const double *x, const double *y, double *z);              // z = x - y
+void simdGemv(int m, int n, const double *A, int lda, const double *x, double *y); // y = A * x
+void simdGram(int m, int n, const double *A, int lda, double *G, int ldg);     // G = A^T * A
@@ -1,7 +1,12 @@
 #include "SupportFunctions.h"
+#include "Simd.h"
 #include <random>
 #include <iomanip>
 #include <vector>
+#include <algorithm>
+#include <numeric>
+#include <cmath>
+#include <limits>
 
 #include "stb_image.h"
 #include "stb_image_write.h"
@@ -9,7 +14,7 @@
 #include <cstring>
 
 Matrix createRandomMatrix(int m, int n) {
-    Matrix M(m, std::vector<double>(n));
+    Matrix M(m, n);
     std::mt19937_64 rng(std::random_device{}());
     std::uniform_real_distribution<double> dist(1e-8 + 1e-16, 1.0 - 1e-16);
 
@@ -39,7 +44,7 @@ void printSmall(const Matrix& M) {
 }
 
 Matrix zeroMatrix(int rows, int cols) {
-    return Matrix(rows, std::vector<double>(cols, 0.0));
+    return Matrix(rows, cols);
 }
 
 Matrix zeroMatrix(int n) {
@@ -49,9 +54,10 @@ Matrix zeroMatrix(int n) {
 // A[row:row+rows-1][col:col+cols-1]
 Matrix subMatrix(const Matrix &A, int row, int col, int rows, int cols) {
     Matrix R = zeroMatrix(rows, cols);
-    for (int i = 0; i < rows; ++i)
-        for (int j = 0; j < cols; ++j)
-            R[i][j] = A[row + i][col + j];
+    for (int i = 0; i < rows; ++i) {
+        const double *src = A[row + i] + col;
+        std::copy(src, src + cols, R[i]);
+    }
     return R;
 }
 
@@ -93,25 +99,14 @@ Matrix trim(const Matrix& A, int rows, int cols) {
     return T;
 }
 
-int rows(const Matrix& M) {
-    return static_cast<int>(M.size());
-}
-
-int cols(const Matrix& M) {
-    return M.size() ? static_cast<int>(M[0].size()) : 0;
-}
-
 Matrix operator+(const Matrix &A, const Matrix &B) {
     Matrix R = zeroMatrix(std::max(rows(A), rows(B)), std::max(cols(A), cols(B)));
     for (int i = 0; i < rows(A); ++i)
         for (int j = 0; j < cols(A); ++j)
             R[i][j] = A[i][j];
 
-    for (int i = 0; i < rows(B); ++i) {
-        for (int j = 0; j < cols(B); ++j)
-            R[i][j] += B[i][j];
-
-    }
+    for (int i = 0; i < rows(B); ++i)
+        simdAdd(cols(B), R[i], B[i], R[i]);
 
     return R;
 }
@@ -122,10 +117,8 @@ Matrix operator-(const Matrix &A, const Matrix &B) {
         for (int j = 0; j < cols(A); ++j)
             R[i][j] = A[i][j];
 
-    for (int i = 0; i < rows(B); ++i) {
-        for (int j = 0; j < cols(B); ++j)
-            R[i][j] -= B[i][j];
-    }
+    for (int i = 0; i < rows(B); ++i)
+        simdSub(cols(B), R[i], B[i], R[i]);
 
     return R;
 }
@@ -134,13 +127,9 @@ Matrix operator*(const Matrix &A, const Matrix &B) {
 
     Matrix C = zeroMatrix(rows(A), cols(B));
     for (int i = 0; i < rows(A); ++i) {
-        for (int k = 0; k < cols(A); ++k) {
-            double aik = A[i][k];
-            for (int j = 0; j < cols(B); ++j) {
-                double prod = aik * B[k][j];
-                C[i][j] += prod;
-            }
-        }
+        double *Ci = C[i];
+        for (int k = 0; k < cols(A); ++k)
+            simdAxpy(cols(B), A[i][k], B[k], Ci);
     }
 
     return C;
@@ -171,17 +160,12 @@ std::pair<bool,double> compareMatrices(const Matrix& X, const Matrix& Y, double
 
 
 double vec_dot(const Vector &a, const Vector &b) {
-    return std::inner_product(a.begin(), a.end(), b.begin(), 0.0);
+    return simdDot(static_cast<int>(a.size()), a.data(), b.data());
 }
 
 Vector mat_vec_mul(const Matrix &M, const Vector &v) {
-    size_t cols = v.size();
     Vector r(rows(M), 0.0);
-    for (int i = 0; i < rows(M); ++i) {
-        double s = 0.0;
-        for (size_t j = 0; j < cols; ++j) s += M[i][j] * v[j];
-        r[i] = s;
-    }
+    simdGemv(rows(M), static_cast<int>(v.size()), M.data(), M.ld(), v.data(), r.data());
     return r;
 }
 
@@ -190,17 +174,14 @@ double vec_norm(const Vector &v) {
 }
 
 Matrix transpose_mul(const Matrix &A) {
-    size_t m = A.size(), n = A.empty() ? 0 : A[0].size();
-    Matrix B(n, Vector(n, 0.0));
-    for (size_t i = 0; i < m; ++i)
-        for (size_t j = 0; j < n; ++j)
-            for (size_t k = 0; k < n; ++k)
-                B[j][k] += A[i][j] * A[i][k];
+    int m = rows(A), n = cols(A);
+    Matrix B(n, n);
+    simdGram(m, n, A.data(), A.ld(), B.data(), B.ld());
     return B;
 }
 
 std::pair<Vector, double> power_iteration(const Matrix &A, int num_simulations) {
-    size_t n = A.size();
+    size_t n = rows(A);
     std::mt19937_64 gen(std::random_device{}());
     std::uniform_real_distribution<double> dist(0.0, 1.0);
     Vector b_k(n);
@@ -219,16 +200,16 @@ std::pair<Vector, double> power_iteration(const Matrix &A, int num_simulations)
 }
 
 bool allclose_zero(const Matrix &M, double atol) {
-    for (const auto &row : M)
-        for (double v : row)
-            if (std::abs(v) > atol) return false;
+    for (int i = 0; i < rows(M); ++i)
+        for (int j = 0; j < cols(M); ++j)
+            if (std::abs(M[i][j]) > atol) return false;
     return true;
 }
 
 std::tuple<Matrix, Vector, Matrix> svd_decomposition(const Matrix &A, int r, double epsilon) {
-    size_t m = A.size(), n = A.empty() ? 0 : A[0].size();
-    Matrix U(m, Vector(r, 0.0));
-    Matrix V(r, Vector(n, 0.0));
+    size_t m = rows(A), n = cols(A);
+    Matrix U(m, r);
+    Matrix V(r, n);
     Vector S;
     Matrix B = transpose_mul(A);
     int num_valid = 0;
@@ -238,19 +219,18 @@ std::tuple<Matrix, Vector, Matrix> svd_decomposition(const Matrix &A, int r, dou
         if (sigma_squared < epsilon * epsilon) break;
         double sigma = std::sqrt(sigma_squared);
         S.push_back(sigma);
-        if ((size_t)i < V.size()) V[i] = v;
+        if (i < rows(V)) std::copy(v.begin(), v.end(), V[i]);
         Vector u = mat_vec_mul(A, v);
         if (sigma != 0.0) for (double &x : u) x /= sigma;
         for (size_t r = 0; r < m; ++r) U[r][num_valid] = u[r];
         for (size_t p = 0; p < n; ++p)
-            for (size_t q = 0; q < n; ++q)
-                B[p][q] -= sigma_squared * v[p] * v[q];
+            simdAxpy(static_cast<int>(n), -sigma_squared * v[p], v.data(), B[p]);
         ++num_valid;
         if (allclose_zero(B, epsilon)) break;
     }
 
-    Matrix U_trim(m, Vector(num_valid));
-    Matrix V_trim(num_valid, Vector(n));
+    Matrix U_trim(m, num_valid);
+    Matrix V_trim(num_valid, n);
     for (size_t r = 0; r < m; ++r)
         for (int c = 0; c < num_valid; ++c)
             U_trim[r][c] = U[r][c];
@@ -266,9 +246,9 @@ std::tuple<Matrix, Matrix, Matrix> loadImageRGB(const std::string& filename) {
     unsigned char *data = stbi_load(filename.c_str(), &w, &h, &c, 3); // force RGB
     if (!data) return {Matrix(), Matrix(), Matrix()};
 
-    Matrix R(h, Vector(w, 0.0));
-    Matrix G(h, Vector(w, 0.0));
-    Matrix B(h, Vector(w, 0.0));
+    Matrix R(h, w);
+    Matrix G(h, w);
+    Matrix B(h, w);
     size_t idx = 0;
     for (int y = 0; y < h; ++y) {
         for (int x = 0; x < w; ++x) {
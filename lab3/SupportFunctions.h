@@ -6,7 +6,8 @@
 #include <tuple>
 #include <string>
 
-using Matrix = std::vector<std::vector<double>>;
+#include "Matrix.h"
+
 using Vector = std::vector<double>;
 
 Matrix createRandomMatrix(int m, int n);
@@ -26,8 +27,6 @@ Matrix negate(const Matrix &A);
 std::pair<bool,double> compareMatrices(const Matrix& X, const Matrix& Y, double tol);
 Matrix pad(const Matrix& A, int rows, int cols);
 Matrix trim(const Matrix& A, int rows, int cols);
-int rows(const Matrix& M);
-int cols(const Matrix& M);
 
 std::tuple<Matrix, Vector, Matrix> svd_decomposition(const Matrix &A, int k, double epsilon = 1e-10);
 
@@ -0,0 +1,44 @@
+#include "SupportFunctions.h"
+#include "Benchmark.h"
+// SupportFunctions.cpp uses stb for image I/O; the implementation lives in
+// the translation unit with main(), as in main.cpp
+#define STB_IMAGE_IMPLEMENTATION
+#define STB_IMAGE_WRITE_IMPLEMENTATION
+#include "stb_image.h"
+#include "stb_image_write.h"
+#include <algorithm>
+#include <iostream>
+
+int main(int argc, char** argv) {
+    BenchConfig config;
+    try {
+        config = parseBenchArgs(argc, argv, {64, 128, 256});
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << "\n"
+                  << "Usage: " << argv[0] << " [--warmup W] [--reps R] [--cpu C]"
+                  << " [--format csv|json] [--out FILE] [N...]\n";
+        return 1;
+    }
+
+    if (config.cpu >= 0 && !pinCurrentThread(config.cpu)) {
+        std::cerr << "Can't pin thread to cpu " << config.cpu << "\n";
+    }
+
+    std::vector<BenchResult> results;
+    for (int n : config.sizes) {
+        Matrix A = createRandomMatrix(n);
+        int k = std::min(n, 8);
+
+        // power iteration has no fixed flop count, so GFLOP/s is not reported
+        results.push_back(runBenchmark("svd_full", n, config, [&] { svd_decomposition(A, n); }, 0.0));
+        results.push_back(runBenchmark("svd_rank" + std::to_string(k), n, config, [&] { svd_decomposition(A, k); }, 0.0));
+    }
+
+    try {
+        writeBenchResults(config, results);
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
@@ -18,9 +18,9 @@ int main(int argc, char** argv) {
 
     auto [R, G, B] = loadImageRGB("doge.png");
 
-    auto [U_R, D_R, V_R] = svd_decomposition(R, size(R));
-    auto [U_G, D_G, V_G] = svd_decomposition(G, size(G));
-    auto [U_B, D_B, V_B] = svd_decomposition(B, size(B));
+    auto [U_R, D_R, V_R] = svd_decomposition(R, rows(R));
+    auto [U_G, D_G, V_G] = svd_decomposition(G, rows(G));
+    auto [U_B, D_B, V_B] = svd_decomposition(B, rows(B));
 
 
     for (double val : D_R) std::cout << val << " ";
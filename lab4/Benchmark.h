@@ -0,0 +1,51 @@
+#pragma once
+
+#include <functional>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+/**
+ * Shared timing harness (bench.cpp).
+ *
+ * Each case is run `warmup` times untimed and then `repetitions` times
+ * timed; the result is a summary over all repetitions instead of a single
+ * run, which jitters too much to spot regressions.
+ */
+struct BenchConfig {
+    int warmup = 2;
+    int repetitions = 10;
+    int cpu = -1;                // core the calling thread is pinned to (-1 = no pinning)
+    std::string format = "csv";  // csv or json
+    std::string output;          // output file, empty = stdout
+    std::vector<int> sizes;      // positional arguments
+};
+
+struct BenchResult {
+    std::string name;
+    int n = 0;
+    int warmup = 0;
+    int repetitions = 0;
+    double min = 0.0;     // times in seconds
+    double median = 0.0;
+    double p90 = 0.0;
+    double mean = 0.0;
+    double stddev = 0.0;
+    double flops = 0.0;   // floating-point operations of one run (0 = unknown)
+    double gflops = 0.0;  // flops / median
+};
+
+// --warmup W --reps R --cpu C --format csv|json --out FILE, the rest are sizes.
+// Throws std::runtime_error on an invalid argument.
+BenchConfig parseBenchArgs(int argc, char **argv, std::vector<int> defaultSizes);
+
+// Pins the calling thread to core `cpu`; false on failure
+bool pinCurrentThread(int cpu);
+
+BenchResult runBenchmark(const std::string &name, int n, const BenchConfig &config,
+                         const std::function<void()> &run, double flops);
+
+void writeBenchResults(std::ostream &out, const std::vector<BenchResult> &results, const std::string &format);
+
+// Writes to config.output (or stdout) in config.format
+void writeBenchResults(const BenchConfig &config, const std::vector<BenchResult> &results);
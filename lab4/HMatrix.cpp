@@ -175,29 +175,24 @@ std::shared_ptr<HNode> hMatrixAdd(const std::shared_ptr<HNode>& A,
         }
         
         // Concatenate U matrices and V matrices, then recompress
-        Matrix U_combined;
-        Matrix V_combined;
-        
-        if (A->rank > 0) {
-            U_combined = A->U;
-            V_combined = A->V;
-        }
-        
-        if (B->rank > 0) {
-            // Extend U_combined with B->U
-            if (U_combined.empty()) {
-                U_combined = B->U;
-                V_combined = B->V;
-            } else {
-                for (int i = 0; i < A->rows; ++i) {
-                    for (int j = 0; j < B->rank; ++j) {
-                        U_combined[i].push_back(B->U[i][j]);
-                    }
-                }
-                for (int i = 0; i < B->rank; ++i) {
-                    V_combined.push_back(B->V[i]);
-                }
+        // U_combined = [U_A U_B], V_combined = [V_A; V_B]
+        int combinedRank = A->rank + B->rank;
+        Matrix U_combined = zeroMatrix(A->rows, combinedRank);
+        Matrix V_combined = zeroMatrix(combinedRank, A->cols);
+        
+        for (int i = 0; i < A->rows; ++i) {
+            for (int j = 0; j < A->rank; ++j) {
+                U_combined[i][j] = A->U[i][j];
             }
+            for (int j = 0; j < B->rank; ++j) {
+                U_combined[i][A->rank + j] = B->U[i][j];
+            }
+        }
+        for (int i = 0; i < A->rank; ++i) {
+            std::copy(A->V[i], A->V[i] + A->cols, V_combined[i]);
+        }
+        for (int i = 0; i < B->rank; ++i) {
+            std::copy(B->V[i], B->V[i] + A->cols, V_combined[A->rank + i]);
         }
         
         // Recompress: compute full matrix and do SVD
@@ -3,8 +3,10 @@
 #include <vector>
 #include <memory>
 #include <tuple>
+#include <string>
+
+#include "Matrix.h"
 
-using Matrix = std::vector<std::vector<double>>;
 using Vector = std::vector<double>;
 
 // H-Matrix Node structure
@@ -52,8 +54,6 @@ Matrix matrixMultiply(const Matrix& A, const Matrix& B);
 Vector matrixVectorMult(const Matrix& A, const Vector& x);
 Matrix zeroMatrix(int rows, int cols);
 Vector zeroVector(int size);
-int rows(const Matrix& M);
-int cols(const Matrix& M);
 double frobeniusNorm(const Matrix& A);
 double vectorError(const Vector& v1, const Vector& v2);
 
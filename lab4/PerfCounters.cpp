@@ -0,0 +1,160 @@
+#include "PerfCounters.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+#ifdef __linux__
+
+int openCounter(unsigned type, unsigned long long config) {
+    perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = type;
+    attr.config = config;
+    attr.exclude_kernel = 1;  // works with perf_event_paranoid <= 2
+    attr.exclude_hv = 1;
+    attr.inherit = 1;         // threads created later are counted as well
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    long fd = syscall(SYS_perf_event_open, &attr, 0, -1, -1, PERF_FLAG_FD_CLOEXEC);
+    return static_cast<int>(fd);
+}
+
+enum class Vendor { Other, Intel, Amd };
+
+Vendor cpuVendor() {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_cpu_init();
+    if (__builtin_cpu_is("intel")) return Vendor::Intel;
+    if (__builtin_cpu_is("amd")) return Vendor::Amd;
+#endif
+    return Vendor::Other;
+}
+
+#endif // __linux__
+
+} // namespace
+
+PerfCounters::PerfCounters(bool enabled) {
+    for (int &fd : fds_) fd = -1;
+#ifdef __linux__
+    if (!enabled) return;
+    fds_[Cycles] = openCounter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+    fds_[Instructions] = openCounter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+    fds_[L1DMisses] = openCounter(PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D |
+                                                          (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                                                          (PERF_COUNT_HW_CACHE_RESULT_MISS << 16));
+    fds_[LLCMisses] = openCounter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+
+    // Raw events: FP_ARITH_INST_RETIRED (0xC7) with the double-precision
+    // scalar/128/256/512-bit umasks, RETIRED_SSE_AVX_FLOPS (0x03) on AMD.
+    switch (cpuVendor()) {
+        case Vendor::Intel:
+            fds_[FpScalar] = openCounter(PERF_TYPE_RAW, 0x01C7);
+            fds_[Fp128] = openCounter(PERF_TYPE_RAW, 0x04C7);
+            fds_[Fp256] = openCounter(PERF_TYPE_RAW, 0x10C7);
+            fds_[Fp512] = openCounter(PERF_TYPE_RAW, 0x40C7);
+            fpWeight_[FpScalar] = 1;
+            fpWeight_[Fp128] = 2;
+            fpWeight_[Fp256] = 4;
+            fpWeight_[Fp512] = 8;
+            break;
+        case Vendor::Amd:
+            fds_[FpScalar] = openCounter(PERF_TYPE_RAW, 0xFF03);
+            fpWeight_[FpScalar] = 1;
+            break;
+        default:
+            break;
+    }
+#else
+    (void)enabled;
+#endif
+}
+
+PerfCounters::~PerfCounters() {
+#ifdef __linux__
+    for (int fd : fds_) {
+        if (fd >= 0) close(fd);
+    }
+#endif
+}
+
+bool PerfCounters::available() const {
+    for (int fd : fds_) {
+        if (fd >= 0) return true;
+    }
+    return false;
+}
+
+PerfCounters::Reading PerfCounters::read(int event) const {
+    Reading r;
+#ifdef __linux__
+    unsigned long long buf[3];
+    if (fds_[event] >= 0 && ::read(fds_[event], buf, sizeof(buf)) == static_cast<ssize_t>(sizeof(buf))) {
+        r.value = buf[0];
+        r.enabled = buf[1];
+        r.running = buf[2];
+    }
+#else
+    (void)event;
+#endif
+    return r;
+}
+
+void PerfCounters::start() {
+    for (int e = 0; e < kEvents; ++e) base_[e] = read(e);
+}
+
+PerfSample PerfCounters::stop() {
+    long long delta[kEvents];
+    for (int e = 0; e < kEvents; ++e) {
+        Reading r = read(e);
+        unsigned long long running = r.running - base_[e].running;
+        if (fds_[e] < 0 || running == 0) {
+            delta[e] = -1;
+            continue;
+        }
+        // multiplexing: the counter was only running part of the time
+        double scale = static_cast<double>(r.enabled - base_[e].enabled) / running;
+        delta[e] = static_cast<long long>(static_cast<double>(r.value - base_[e].value) * scale);
+    }
+
+    PerfSample s;
+    s.cycles = delta[Cycles];
+    s.instructions = delta[Instructions];
+    s.l1d_misses = delta[L1DMisses];
+    s.llc_misses = delta[LLCMisses];
+    for (int e = FpScalar; e < kEvents; ++e) {
+        if (fpWeight_[e] == 0) continue;
+        if (delta[e] < 0) {
+            s.fp_ops = -1;
+            break;
+        }
+        s.fp_ops = (s.fp_ops < 0 ? 0 : s.fp_ops) + fpWeight_[e] * delta[e];
+    }
+    return s;
+}
+
+bool perfCountersRequested() {
+    const char *env = std::getenv("MATRIX_PERF");
+    return env && *env && std::strcmp(env, "0") != 0;
+}
+
+std::string perfSampleString(const PerfSample &sample) {
+    std::ostringstream out;
+    for (long long v : {sample.cycles, sample.instructions, sample.l1d_misses, sample.llc_misses, sample.fp_ops}) {
+        if (out.tellp() > 0) out << " ";
+        if (v < 0) out << "-";
+        else out << v;
+    }
+    return out.str();
+}
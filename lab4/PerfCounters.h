@@ -0,0 +1,62 @@
+#pragma once
+
+#include <string>
+
+/**
+ * Hardware performance counters (Linux perf_event_open) around a timed
+ * region: cycles, instructions, L1D read misses, LLC misses and retired
+ * double-precision floating-point operations.
+ *
+ * A counter that cannot be opened (no PMU inside a VM, perf_event_paranoid,
+ * non-Linux system, unknown CPU for fp_ops) reads as -1 and is written as
+ * "-" in the result files. Multiplexed counters are scaled by the fraction
+ * of time they were actually running.
+ *
+ * Threads created after construction inherit the counters.
+ */
+struct PerfSample {
+    long long cycles = -1;
+    long long instructions = -1;
+    long long l1d_misses = -1;
+    long long llc_misses = -1;
+    long long fp_ops = -1;
+};
+
+class PerfCounters {
+public:
+    // enabled = false: nothing is opened and stop() returns all -1
+    explicit PerfCounters(bool enabled = true);
+    ~PerfCounters();
+
+    PerfCounters(const PerfCounters &) = delete;
+    PerfCounters &operator=(const PerfCounters &) = delete;
+
+    // true if at least one counter could be opened
+    bool available() const;
+
+    void start();
+    PerfSample stop();
+
+private:
+    // Intel counts FP_ARITH_INST_RETIRED separately per vector width
+    // (weights 1/2/4/8), AMD reports operations directly (FpScalar only).
+    enum Event { Cycles, Instructions, L1DMisses, LLCMisses, FpScalar, Fp128, Fp256, Fp512, kEvents };
+
+    struct Reading {
+        unsigned long long value = 0;
+        unsigned long long enabled = 0;
+        unsigned long long running = 0;
+    };
+
+    Reading read(int event) const;
+
+    int fds_[kEvents];
+    int fpWeight_[kEvents] = {};
+    Reading base_[kEvents];
+};
+
+// Whether counters are enabled through the MATRIX_PERF environment variable (!= "0")
+bool perfCountersRequested();
+
+// "cycles instructions l1d_misses llc_misses fp_ops" separated by spaces, "-" = unavailable
+std::string perfSampleString(const PerfSample &sample);
@@ -1,4 +1,5 @@
 #include "HMatrix.h"
+#include "Simd.h"
 #include <cmath>
 #include <random>
 #include <iostream>
@@ -17,7 +18,7 @@
 // ============================================================================
 
 Matrix createRandomMatrix(int m, int n) {
-    Matrix M(m, Vector(n));
+    Matrix M(m, n);
     std::mt19937_64 rng(std::random_device{}());
     std::uniform_real_distribution<double> dist(1e-8 + 1e-16, 1.0 - 1e-16);
 
@@ -43,11 +44,10 @@ Matrix identityMatrix(int n) {
 // ============================================================================
 
 Matrix subMatrix(const Matrix& A, int startRow, int startCol, int numRows, int numCols) {
-    Matrix result(numRows, Vector(numCols));
+    Matrix result(numRows, numCols);
     for (int i = 0; i < numRows; ++i) {
-        for (int j = 0; j < numCols; ++j) {
-            result[i][j] = A[startRow + i][startCol + j];
-        }
+        const double* src = A[startRow + i] + startCol;
+        std::copy(src, src + numCols, result[i]);
     }
     return result;
 }
@@ -59,7 +59,7 @@ Matrix combineBlocks(const Matrix& A11, const Matrix& A12,
     int cols1 = cols(A11);
     int cols2 = cols(A12);
     
-    Matrix result(rows1 + rows2, Vector(cols1 + cols2));
+    Matrix result(rows1 + rows2, cols1 + cols2);
     
     // Top-left
     for (int i = 0; i < rows1; ++i) {
@@ -104,12 +104,9 @@ Matrix matrixMultiply(const Matrix& A, const Matrix& B) {
     Matrix result = zeroMatrix(m, n);
     
     for (int i = 0; i < m; ++i) {
-        for (int j = 0; j < n; ++j) {
-            double sum = 0.0;
-            for (int p = 0; p < k; ++p) {
-                sum += A[i][p] * B[p][j];
-            }
-            result[i][j] = sum;
+        double* Ri = result[i];
+        for (int p = 0; p < k; ++p) {
+            simdAxpy(n, A[i][p], B[p], Ri);
         }
     }
     
@@ -125,37 +122,23 @@ Vector matrixVectorMult(const Matrix& A, const Vector& x) {
     }
     
     Vector result(m, 0.0);
-    
-    for (int i = 0; i < m; ++i) {
-        for (int j = 0; j < n; ++j) {
-            result[i] += A[i][j] * x[j];
-        }
-    }
-    
+    simdGemv(m, n, A.data(), A.ld(), x.data(), result.data());
     return result;
 }
 
 Matrix zeroMatrix(int rows, int cols) {
-    return Matrix(rows, Vector(cols, 0.0));
+    return Matrix(rows, cols);
 }
 
 Vector zeroVector(int size) {
     return Vector(size, 0.0);
 }
 
-int rows(const Matrix& M) {
-    return static_cast<int>(M.size());
-}
-
-int cols(const Matrix& M) {
-    return M.empty() ? 0 : static_cast<int>(M[0].size());
-}
-
 double frobeniusNorm(const Matrix& A) {
     double sum = 0.0;
-    for (const auto& row : A) {
-        for (double val : row) {
-            sum += val * val;
+    for (int i = 0; i < rows(A); ++i) {
+        for (int j = 0; j < cols(A); ++j) {
+            sum += A[i][j] * A[i][j];
         }
     }
     return std::sqrt(sum);
@@ -179,11 +162,7 @@ double vectorError(const Vector& v1, const Vector& v2) {
 // ============================================================================
 
 double vec_dot(const Vector& a, const Vector& b) {
-    double result = 0.0;
-    for (size_t i = 0; i < a.size(); ++i) {
-        result += a[i] * b[i];
-    }
-    return result;
+    return simdDot(static_cast<int>(a.size()), a.data(), b.data());
 }
 
 Vector mat_vec_mul(const Matrix& M, const Vector& v) {
@@ -198,29 +177,21 @@ Matrix transpose_mul(const Matrix& A) {
     int m = rows(A);
     int n = cols(A);
     Matrix result = zeroMatrix(n, n);
-    
-    for (int i = 0; i < n; ++i) {
-        for (int j = 0; j < n; ++j) {
-            for (int k = 0; k < m; ++k) {
-                result[i][j] += A[k][i] * A[k][j];
-            }
-        }
-    }
-    
+    simdGram(m, n, A.data(), A.ld(), result.data(), result.ld());
     return result;
 }
 
 bool allclose_zero(const Matrix& M, double atol) {
-    for (const auto& row : M) {
-        for (double val : row) {
-            if (std::abs(val) > atol) return false;
+    for (int i = 0; i < rows(M); ++i) {
+        for (int j = 0; j < cols(M); ++j) {
+            if (std::abs(M[i][j]) > atol) return false;
         }
     }
     return true;
 }
 
 std::pair<Vector, double> power_iteration(const Matrix& A, int num_simulations) {
-    size_t n = A.size();
+    size_t n = rows(A);
     std::mt19937_64 gen(std::random_device{}());
     std::uniform_real_distribution<double> dist(0.0, 1.0);
     Vector b_k(n);
@@ -240,11 +211,11 @@ std::pair<Vector, double> power_iteration(const Matrix& A, int num_simulations)
 }
 
 std::tuple<Matrix, Vector, Matrix> svd_decomposition(const Matrix& A, int r, double epsilon) {
-    size_t m = A.size();
-    size_t n = A.empty() ? 0 : A[0].size();
+    size_t m = rows(A);
+    size_t n = cols(A);
     
-    Matrix U(m, Vector(r, 0.0));
-    Matrix V(r, Vector(n, 0.0));
+    Matrix U(m, r);
+    Matrix V(r, n);
     Vector S;
     Matrix B = transpose_mul(A);
     int num_valid = 0;
@@ -254,19 +225,18 @@ std::tuple<Matrix, Vector, Matrix> svd_decomposition(const Matrix& A, int r, dou
         if (sigma_squared < epsilon * epsilon) break;
         double sigma = std::sqrt(sigma_squared);
         S.push_back(sigma);
-        if ((size_t)i < V.size()) V[i] = v;
+        if (i < rows(V)) std::copy(v.begin(), v.end(), V[i]);
         Vector u = mat_vec_mul(A, v);
         if (sigma != 0.0) for (double& x : u) x /= sigma;
         for (size_t r_idx = 0; r_idx < m; ++r_idx) U[r_idx][num_valid] = u[r_idx];
         for (size_t p = 0; p < n; ++p)
-            for (size_t q = 0; q < n; ++q)
-                B[p][q] -= sigma_squared * v[p] * v[q];
+            simdAxpy(static_cast<int>(n), -sigma_squared * v[p], v.data(), B[p]);
         ++num_valid;
         if (allclose_zero(B, epsilon)) break;
     }
 
-    Matrix U_trim(m, Vector(num_valid));
-    Matrix V_trim(num_valid, Vector(n));
+    Matrix U_trim(m, num_valid);
+    Matrix V_trim(num_valid, n);
     for (size_t r_idx = 0; r_idx < m; ++r_idx)
         for (int c = 0; c < num_valid; ++c)
             U_trim[r_idx][c] = U[r_idx][c];
@@ -287,8 +257,7 @@ Matrix operator+(const Matrix& A, const Matrix& B) {
     }
     Matrix R = zeroMatrix(rows(A), cols(A));
     for (int i = 0; i < rows(A); ++i)
-        for (int j = 0; j < cols(A); ++j)
-            R[i][j] = A[i][j] + B[i][j];
+        simdAdd(cols(A), A[i], B[i], R[i]);
     return R;
 }
 
@@ -298,8 +267,7 @@ Matrix operator-(const Matrix& A, const Matrix& B) {
     }
     Matrix R = zeroMatrix(rows(A), cols(A));
     for (int i = 0; i < rows(A); ++i)
-        for (int j = 0; j < cols(A); ++j)
-            R[i][j] = A[i][j] - B[i][j];
+        simdSub(cols(A), A[i], B[i], R[i]);
     return R;
 }
 
@@ -363,9 +331,9 @@ std::tuple<Matrix, Matrix, Matrix> loadImageRGB(const std::string& filename) {
     unsigned char* data = stbi_load(filename.c_str(), &w, &h, &c, 3); // force RGB
     if (!data) return {Matrix(), Matrix(), Matrix()};
 
-    Matrix R(h, Vector(w, 0.0));
-    Matrix G(h, Vector(w, 0.0));
-    Matrix B(h, Vector(w, 0.0));
+    Matrix R(h, w);
+    Matrix G(h, w);
+    Matrix B(h, w);
     size_t idx = 0;
     for (int y = 0; y < h; ++y) {
         for (int x = 0; x < w; ++x) {
@@ -0,0 +1,56 @@
+#include "HMatrix.h"
+#include "Benchmark.h"
+#include <iostream>
+
+// Flops of one hMatrixVectorMult: U * (V * x) in every low-rank leaf plus
+// the additions that merge the children's partial results
+static double hMatrixVectorFlops(const std::shared_ptr<HNode>& H) {
+    if (!H) return 0.0;
+    if (H->isLeaf()) return 2.0 * H->rank * (H->rows + H->cols);
+    double flops = H->rows;
+    for (const auto& son : H->sons) flops += hMatrixVectorFlops(son);
+    return flops;
+}
+
+int main(int argc, char** argv) {
+    BenchConfig config;
+    try {
+        // positional arguments are grid parameters k (matrix size 2^(3k))
+        config = parseBenchArgs(argc, argv, {2, 3});
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << "\n"
+                  << "Usage: " << argv[0] << " [--warmup W] [--reps R] [--cpu C]"
+                  << " [--format csv|json] [--out FILE] [k...]\n";
+        return 1;
+    }
+
+    if (config.cpu >= 0 && !pinCurrentThread(config.cpu)) {
+        std::cerr << "Can't pin thread to cpu " << config.cpu << "\n";
+    }
+
+    const int maxRank = 8;
+    const double epsilon = 1e-6;
+
+    std::vector<BenchResult> results;
+    for (int k : config.sizes) {
+        Matrix A = generate3DGridMatrix(k);
+        int n = rows(A);
+        Vector x(n, 1.0);
+
+        auto H = buildHMatrix(A, maxRank, epsilon);
+
+        // build and H*H have no fixed flop count (adaptive SVD ranks)
+        results.push_back(runBenchmark("buildHMatrix", n, config, [&] { buildHMatrix(A, maxRank, epsilon); }, 0.0));
+        results.push_back(runBenchmark("hMatrixVectorMult", n, config, [&] { hMatrixVectorMult(H, x); },
+                                       hMatrixVectorFlops(H)));
+        results.push_back(runBenchmark("hMatrixMult", n, config, [&] { hMatrixMult(H, H, maxRank, epsilon); }, 0.0));
+    }
+
+    try {
+        writeBenchResults(config, results);
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
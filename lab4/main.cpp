@@ -1,4 +1,5 @@
 #include "HMatrix.h"
+#include "PerfCounters.h"
 #include <iostream>
 #include <chrono>
 #include <fstream>
@@ -16,10 +17,10 @@ void saveMatrixToFile(const Matrix& M, const std::string& filename) {
         return;
     }
     
-    for (const auto& row : M) {
-        for (size_t i = 0; i < row.size(); ++i) {
-            file << row[i];
-            if (i < row.size() - 1) file << " ";
+    for (int r = 0; r < rows(M); ++r) {
+        for (int i = 0; i < cols(M); ++i) {
+            file << M[r][i];
+            if (i < cols(M) - 1) file << " ";
         }
         file << "\n";
     }
@@ -29,16 +30,21 @@ void saveMatrixToFile(const Matrix& M, const std::string& filename) {
 // Save timing results
 void saveTimingResults(const std::string& filename, 
                        const std::vector<int>& sizes,
-                       const std::vector<double>& times) {
+                       const std::vector<double>& times,
+                       const std::vector<PerfSample>& perf) {
     std::ofstream file(filename);
     if (!file.is_open()) {
         std::cerr << "Error opening file: " << filename << std::endl;
         return;
     }
     
-    file << "# Size Time(ms)\n";
+    // Perf columns only with MATRIX_PERF=1, so the default files stay numeric
+    bool withPerf = perfCountersRequested();
+    file << "# Size Time(ms)" << (withPerf ? " cycles instructions l1d_misses llc_misses fp_ops" : "") << "\n";
     for (size_t i = 0; i < sizes.size(); ++i) {
-        file << sizes[i] << " " << times[i] << "\n";
+        file << sizes[i] << " " << times[i];
+        if (withPerf) file << " " << perfSampleString(perf[i]);
+        file << "\n";
     }
     file.close();
 }
@@ -57,6 +63,14 @@ int main() {
     std::vector<double> matMultTimes;
     std::vector<double> vecErrors;
     std::vector<double> matErrors;
+    std::vector<PerfSample> vecMultPerf;
+    std::vector<PerfSample> matMultPerf;
+
+    // Hardware counters around the timed multiplications (MATRIX_PERF=1)
+    PerfCounters perf(perfCountersRequested());
+    if (perfCountersRequested() && !perf.available()) {
+        std::cout << "(perf hardware counters unavailable - perf columns are \"-\")" << std::endl;
+    }
     
     for (int k : k_values) {
         int n = 1 << (3 * k);  // 2^(3k)
@@ -97,9 +111,11 @@ int main() {
         for (int i = 0; i < n; ++i) x[i] = dis(gen);
         
         // Time H-Matrix multiplication
+        perf.start();
         start = high_resolution_clock::now();
         Vector Hx = hMatrixVectorMult(H, x);
         end = high_resolution_clock::now();
+        vecMultPerf.push_back(perf.stop());
         double hvTime = duration_cast<microseconds>(end - start).count() / 1000.0;
         vecMultTimes.push_back(hvTime);
         std::cout << " done (" << hvTime << " ms)" << std::endl;
@@ -119,9 +135,11 @@ int main() {
         // Step 5: Matrix-Matrix multiplication (A^2)
         std::cout << "[5/7] Testing H-Matrix * H-Matrix (squaring)..." << std::flush;
         
+        perf.start();
         start = high_resolution_clock::now();
         auto H2 = hMatrixMult(H, H, maxRank, epsilon);
         end = high_resolution_clock::now();
+        matMultPerf.push_back(perf.stop());
         double mmTime = duration_cast<milliseconds>(end - start).count();
         matMultTimes.push_back(mmTime);
         std::cout << " done (" << mmTime << " ms)" << std::endl;
@@ -162,10 +180,10 @@ int main() {
     
     // Save timing results
     std::cout << "\n=== Saving Results ===" << std::endl;
-    saveTimingResults("timing_vector_mult.txt", sizes, vecMultTimes);
+    saveTimingResults("timing_vector_mult.txt", sizes, vecMultTimes, vecMultPerf);
     std::cout << "Vector multiplication times saved to timing_vector_mult.txt" << std::endl;
     
-    saveTimingResults("timing_matrix_mult.txt", sizes, matMultTimes);
+    saveTimingResults("timing_matrix_mult.txt", sizes, matMultTimes, matMultPerf);
     std::cout << "Matrix multiplication times saved to timing_matrix_mult.txt" << std::endl;
     
     // Save errors
@@ -9,8 +9,8 @@ import matplotlib.pyplot as plt
 from pathlib import Path
 
 def load_timing_data(filename):
-    """Wczytaj dane czasowe z pliku"""
-    data = np.loadtxt(filename, comments='#')
+    """Wczytaj dane czasowe z pliku (kolumny perf, gdy są, pomijane)"""
+    data = np.loadtxt(filename, comments='#', usecols=(0, 1))
     if data.ndim == 1:
         data = data.reshape(1, -1)
     sizes = data[:, 0].astype(int)